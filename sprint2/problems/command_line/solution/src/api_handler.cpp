@@ -1,9 +1,12 @@
 #include "api_handler.h"
 #include "dto.h"
 #include "json_loader.h"
+#include "json_writer.h"
 #include <boost/json.hpp>
+#include <cctype>
+#include <charconv>
+#include <limits>
 #include <ranges>
-#include <set>
 
 namespace http_handler {
 
@@ -11,27 +14,44 @@ namespace rs = std::ranges;
 namespace rv = std::ranges::views;
 namespace sys = boost::system;
 
+    /// @brief Проверка формата токена (32 символа из набора \w) без построения regex
+    bool IsValidToken(std::string_view token){
+        return token.size() == 32
+            && rs::all_of(token, [](unsigned char c){ return std::isalnum(c) || c == '_'; });
+    }
+
+    /// @brief Проверка допустимого значения move
+    bool IsValidMove(std::string_view move){
+        return move.empty() || move == "L"sv || move == "R"sv || move == "U"sv || move == "D"sv;
+    }
+
+    std::string_view GetBearerToken(std::string_view authorization){
+        if (!authorization.starts_with("Bearer "sv) || !IsValidToken(authorization.substr(7))){
+            return {};
+        }
+
+        return authorization.substr(7);
+    }
+
     std::optional<std::string> GetAuthToken(StringRequest& request){
         std::string authorization = request[http::field::authorization];
 
-        if (authorization.empty() || !std::regex_match(authorization, std::regex{"^Bearer \\w{32}"s})){
+        auto token = GetBearerToken(authorization);
+
+        if (token.empty()){
             return std::nullopt;
         }
 
-        return authorization.substr(7);
+        return std::string{token};
     }
 
 
     JsonResponse HandleGetMaps(const app::Application& application, StringRequest&& request){
         // получить список карт
-        auto maps = application.GetMaps();
-
-        // спроецировать в DTO
+        const auto& maps = application.GetMaps();
 
-        auto mapsDto = maps | rv::transform([](auto arg){return dto::MapRegistryDto {arg};});
-
-        // отправить массив DTO
-        return Json(request, mapsDto);
+        // записать id и name каждой карты прямо в тело ответа
+        return StreamJson(request, [&maps](std::string& body){ json_writer::WriteMaps(body, maps); });
     }
 
     JsonResponse HandleGetMapByName(app::Application& application, StringRequest&& request, const std::string& mapName){
@@ -42,7 +62,11 @@ namespace sys = boost::system;
             return Json(request, dto::ErrorDto {"mapNotFound"s, "Map not found"s}, http::status::not_found);
         }
 
-        return Json(request, map);
+        if (AcceptsBinary(request)){
+            return Binary(request, [map](std::string& body){ binary::EncodeMap(body, *map); });
+        }
+
+        return StreamJson(request, [map](std::string& body){ json_writer::WriteMap(body, *map); });
     }
 
     JsonResponse HandleJoinGame(app::Application& application, StringRequest&& request){
@@ -80,7 +104,8 @@ namespace sys = boost::system;
 
         std::string userName = json::value_to<std::string>(body["userName"s]);
 
-        if (userName.empty())
+        // имя уходит в таблицу рекордов, где его длина ограничена
+        if (userName.empty() || userName.size() > records::MAX_NAME_LENGTH)
         {
             return Json(request, 
                 dto::ErrorDto {"invalidArgument"s, "Invalid name"s }, 
@@ -100,7 +125,9 @@ namespace sys = boost::system;
 
         auto player = application.JoinGame(userName, mapId);
 
-        return Json(request, dto::AuthTokenDto {player.token, player.id});
+        dto::AuthTokenDto token {player.token, player.id};
+
+        return StreamJson(request, [&token](std::string& body){ json_writer::WriteAuthToken(body, token); });
     }
 
     JsonResponse HandleGetPlayers(app::Application& application, StringRequest&& request){
@@ -124,13 +151,30 @@ namespace sys = boost::system;
 
         auto players = application.GetPlayersFromSession(player.value().sessionId);
 
-        json::object jv;
+        return StreamJson(request, [&players](std::string& body){ json_writer::WritePlayers(body, players); });
+    }
+
+    std::optional<std::string> GetQueryParameter(std::string_view target, std::string_view name){
+        auto queryPos = target.find('?');
+
+        if (queryPos == std::string_view::npos){
+            return std::nullopt;
+        }
+
+        auto query = target.substr(queryPos + 1);
 
-        for(const auto &player : players){
-            jv[std::to_string(player.id)] = { {"name"s, player.name} };
+        while (!query.empty()){
+            auto paramEnd = query.find('&');
+            auto param = query.substr(0, paramEnd);
+
+            if (param.starts_with(name) && param.size() > name.size() && param[name.size()] == '='){
+                return std::string(param.substr(name.size() + 1));
+            }
+
+            query = paramEnd == std::string_view::npos ? std::string_view{} : query.substr(paramEnd + 1);
         }
 
-        return Json(request, jv);
+        return std::nullopt;
     }
 
     JsonResponse HandleGetGameState(app::Application& application, StringRequest&& request){
@@ -160,39 +204,33 @@ namespace sys = boost::system;
             return Json(request, dto::ErrorDto { "sessionNotFound"s, "Session not found"s}, http::status::internal_server_error);
         }
 
-        json::object obj;
-
-        for (const auto dog : session->GetDogs()){
+        std::string target = request.target();
 
-            std::string direction;
+        // ?since=N - только собаки, изменившиеся после версии N
+        std::optional<uint64_t> since;
 
-            switch (dog.direction)
-            {
-            case model::NORTH:
-                direction = "U"s;
-                break;
+        if (auto sinceParameter = GetQueryParameter(target, "since"sv)){
+            uint64_t version = 0;
 
-            case model::SOUTH:
-                direction = "D"s;
-                break;
+            auto [ptr, ec] = std::from_chars(sinceParameter->data(), sinceParameter->data() + sinceParameter->size(), version);
 
-            case model::EAST:
-                direction = "R"s;
-                break;
-
-            case model::WEST:
-                direction = "L"s;
-                break;
+            if (ec != std::errc{} || ptr != sinceParameter->data() + sinceParameter->size()){
+                return Json(request, dto::ErrorDto {"invalidArgument"s, "Invalid since parameter"s}, http::status::bad_request);
             }
 
-            obj[std::to_string(dog.playerId)] = {
-                {"pos"s, {dog.coord.x, dog.coord.y}},
-                {"speed"s, {dog.speed.vx, dog.speed.vy}},
-                {"dir"s, direction}
-            };
+            since = version;
+        }
 
+        // двоичный формат всегда содержит версию и признак полного снимка
+        if (AcceptsBinary(request)){
+            return Binary(request, [session, since](std::string& body){ binary::EncodeGameState(body, *session, since); });
         }
-        return Json(request, json::object {{"players"s, obj}});
+
+        if (since){
+            return StreamJson(request, [session, since](std::string& body){ json_writer::WriteVersionedGameState(body, *session, since); });
+        }
+
+        return StreamJson(request, [session](std::string& body){ json_writer::WriteGameState(body, *session); });
     }
 
     JsonResponse HandlePostPlayerAction(app::Application& application, StringRequest&& request){
@@ -230,9 +268,7 @@ namespace sys = boost::system;
 
         auto move = json::value_to<std::string>(body.at("move"s));
 
-        std::set<std::string> validValues {"L"s, "R"s, "U"s, "D"s, ""s};
-
-        if (!validValues.contains(move))
+        if (!IsValidMove(move))
         {
             return Json(request, dto::ErrorDto{"invalidArgument"s, "Failed to parse action"s}, http::status::bad_request);
         }
@@ -242,6 +278,97 @@ namespace sys = boost::system;
         return Json(request, json::object{});
     }
 
+    JsonResponse HandlePostPlayerActions(app::Application& application, StringRequest&& request){
+        if (request.method() != http::verb::post){
+            auto response = Json(request, dto::ErrorDto {"invalidMethod"s, "Invalid method"s}, http::status::method_not_allowed);
+
+            response.set(http::field::allow, "POST"s);
+
+            return response;
+        }
+
+        if (request[http::field::content_type] != "application/json"s){
+            return Json(request, dto::ErrorDto {"invalidArgument"s, "Invalid content type"s}, http::status::bad_request);
+        }
+
+        sys::error_code ec;
+
+        auto body = json::parse(request.body(), ec);
+
+        if (ec || !body.is_array()) {
+            return Json(request, dto::ErrorDto{"invalidArgument"s, "Failed to parse actions"s}, http::status::bad_request);
+        }
+
+        // токен из заголовка используется для элементов без собственного поля token
+        auto headerToken = GetAuthToken(request);
+
+        std::vector<app::PlayerAction> actions;
+        std::vector<size_t> actionIndexes;
+        std::vector<std::optional<dto::ErrorDto>> errors;
+
+        actions.reserve(body.as_array().size());
+        actionIndexes.reserve(body.as_array().size());
+        errors.reserve(body.as_array().size());
+
+        // один проход: проверка формата каждого элемента, невалидные элементы не применяются
+        for (const auto& item : body.as_array()){
+            const auto* action = item.if_object();
+
+            const auto* moveValue = action ? action->if_contains("move"s) : nullptr;
+
+            if (!moveValue || !moveValue->is_string()){
+                errors.emplace_back(dto::ErrorDto{"invalidArgument"s, "Failed to parse action"s});
+                continue;
+            }
+
+            auto move = json::value_to<std::string>(*moveValue);
+
+            if (!IsValidMove(move)){
+                errors.emplace_back(dto::ErrorDto{"invalidArgument"s, "Failed to parse action"s});
+                continue;
+            }
+
+            std::optional<std::string> token = headerToken;
+
+            if (const auto* tokenValue = action->if_contains("token"s)){
+                token = tokenValue->is_string()
+                    ? std::optional<std::string>{json::value_to<std::string>(*tokenValue)}
+                    : std::nullopt;
+
+                if (token && !IsValidToken(*token)){
+                    token = std::nullopt;
+                }
+            }
+
+            if (!token){
+                errors.emplace_back(dto::ErrorDto {"invalidToken"s, "Player token is invalid"s});
+                continue;
+            }
+
+            actions.emplace_back(app::PlayerAction {std::move(*token), std::move(move)});
+            actionIndexes.emplace_back(errors.size());
+            errors.emplace_back(std::nullopt);
+        }
+
+        auto applied = application.MoveBatch(actions);
+
+        for (size_t i = 0; i < applied.size(); ++i){
+            if (!applied[i]){
+                errors[actionIndexes[i]] = dto::ErrorDto{"unknownToken"s, "Player token has not been found"s};
+            }
+        }
+
+        json::array results;
+
+        results.reserve(errors.size());
+
+        for (const auto& error : errors){
+            results.emplace_back(error ? json::value_from(*error) : json::value(json::object{}));
+        }
+
+        return Json(request, json::value(std::move(results)));
+    }
+
     JsonResponse HandlePostGameTick(app::Application& application, StringRequest&& request){
         if (request.method() != http::verb::post){
             auto response = Json(request, dto::ErrorDto {"invalidMethod"s, "Invalid method"s}, http::status::method_not_allowed);
@@ -270,6 +397,80 @@ namespace sys = boost::system;
         return Json(request, json::object{});
     }
 
+    JsonResponse HandleGetMetrics(app::Application& application, const RequestGuard& guard, const StrandMetrics& strandMetrics, StringRequest&& request){
+        if (request.method() != http::verb::get && request.method() != http::verb::head){
+            auto response = Json(request, dto::ErrorDto {"invalidMethod"s, "Invalid method"s}, http::status::method_not_allowed);
+            response.set(http::field::allow, "GET, HEAD"s);
+            return response;
+        }
+
+        const auto metrics = application.GetMetrics();
+        const auto requests = guard.GetCounters();
+
+        return StreamJson(request, [&metrics, &requests, &strandMetrics](std::string& body){
+            json_writer::WriteMetrics(body, metrics, requests, strandMetrics);
+        });
+    }
+
+    JsonResponse HandleGetRecords(records::RecordsRepository& repository, StringRequest&& request){
+        if (request.method() != http::verb::get && request.method() != http::verb::head){
+            auto response = Json(request, dto::ErrorDto {"invalidMethod"s, "Invalid method"s}, http::status::method_not_allowed);
+            response.set(http::field::allow, "GET, HEAD"s);
+            return response;
+        }
+
+        std::string target = request.target();
+
+        size_t start = 0;
+        size_t maxItems = MAX_RECORDS_ITEMS;
+
+        // ?start=N&maxItems=M, оба параметра необязательны
+        for (auto [name, value] : {std::pair{"start"sv, &start}, std::pair{"maxItems"sv, &maxItems}}){
+            auto parameter = GetQueryParameter(target, name);
+
+            if (!parameter){
+                continue;
+            }
+
+            auto [ptr, ec] = std::from_chars(parameter->data(), parameter->data() + parameter->size(), *value);
+
+            if (ec != std::errc{} || ptr != parameter->data() + parameter->size()){
+                return Json(request, dto::ErrorDto {"invalidArgument"s, "Invalid "s + std::string(name) + " parameter"s}, http::status::bad_request);
+            }
+        }
+
+        if (maxItems > MAX_RECORDS_ITEMS){
+            return Json(request, dto::ErrorDto {"invalidArgument"s, "maxItems is too large"s}, http::status::bad_request);
+        }
+
+        // OFFSET в базе - bigint
+        if (start > static_cast<size_t>(std::numeric_limits<int64_t>::max())){
+            return Json(request, dto::ErrorDto {"invalidArgument"s, "start is too large"s}, http::status::bad_request);
+        }
+
+        std::vector<records::Record> page;
+
+        try {
+            page = repository.Load(start, maxItems);
+        } catch (const std::exception&){
+            return Json(request, dto::ErrorDto {"internalError"s, "Failed to load records"s}, http::status::internal_server_error);
+        }
+
+        json::array result;
+        result.reserve(page.size());
+
+        for (const auto& record : page){
+            result.push_back(json::object {
+                {"name"s, record.name},
+                {"score"s, record.score},
+                // время в игре отдается в секундах
+                {"playTime"s, static_cast<double>(record.playTime) / 1000.0}
+            });
+        }
+
+        return Json(request, json::value(std::move(result)));
+    }
+
     JsonResponse HandleBadRequest(StringRequest&& request){
         return Json(request, dto::ErrorDto {"badRequest"s, "Bad request"s}, http::status::bad_request);
     }
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "application.h"
+#include "binary_encoder.h"
+#include "records.h"
+#include "request_guard.h"
+#include "strand_metrics.h"
 #include <boost/beast/http.hpp>
 #include <boost/json.hpp>
 #include <regex>
@@ -48,6 +52,55 @@ namespace http_handler {
         return response;
     }
 
+    /// @brief JSON-ответ, encode пишет JSON прямо в тело ответа без построения json::value
+    template <typename Body, typename Allocator, typename Encoder>
+    JsonResponse StreamJson(
+        const http::request<Body, http::basic_fields<Allocator>>& request,
+        Encoder&& encode,
+        http::status status_code = http::status::ok)
+    {
+        JsonResponse response {status_code, request.version()};
+        response.set(http::field::content_type, "application/json");
+        response.set(http::field::cache_control, "no-cache");
+        encode(response.body());
+        response.keep_alive(request.keep_alive());
+        response.prepare_payload();
+        return response;
+    }
+
+    /// @brief Ответ в двоичном формате, encode дописывает данные прямо в тело ответа
+    template <typename Body, typename Allocator, typename Encoder>
+    JsonResponse Binary(
+        const http::request<Body, http::basic_fields<Allocator>>& request,
+        Encoder&& encode,
+        http::status status_code = http::status::ok)
+    {
+        JsonResponse response {status_code, request.version()};
+        response.set(http::field::content_type, binary::CONTENT_TYPE);
+        response.set(http::field::cache_control, "no-cache");
+        encode(response.body());
+        response.keep_alive(request.keep_alive());
+        response.prepare_payload();
+        return response;
+    }
+
+    /// @brief Клиент запросил двоичное представление через заголовок Accept
+    template <typename Body, typename Allocator>
+    bool AcceptsBinary(const http::request<Body, http::basic_fields<Allocator>>& request) {
+        std::string accept = request[http::field::accept];
+
+        return accept.find(binary::CONTENT_TYPE) != std::string::npos;
+    }
+
+    /// @brief Проверка формата токена авторизации
+    bool IsValidToken(std::string_view token);
+
+    /// @brief Токен из заголовка Authorization или пустая строка, если токена нет или он некорректен
+    std::string_view GetBearerToken(std::string_view authorization);
+
+    /// @brief Значение параметра name из строки запроса target
+    std::optional<std::string> GetQueryParameter(std::string_view target, std::string_view name);
+
     JsonResponse HandleGetMaps(const app::Application& application, StringRequest&& request);
 
     JsonResponse HandleGetMapByName(app::Application& application, StringRequest&& request, const std::string& mapName);
@@ -62,19 +115,33 @@ namespace http_handler {
 
     JsonResponse HandlePostPlayerAction(app::Application& application, StringRequest&& request);
 
+    JsonResponse HandlePostPlayerActions(app::Application& application, StringRequest&& request);
+
     JsonResponse HandlePostGameTick(app::Application& application, StringRequest&& request);
 
+    JsonResponse HandleGetMetrics(app::Application& application, const RequestGuard& guard, const StrandMetrics& strandMetrics, StringRequest&& request);
+
+    /// @brief Больше результатов за один запрос /api/v1/game/records не отдается
+    constexpr size_t MAX_RECORDS_ITEMS = 100;
+
+    /// @brief Таблица рекордов ушедших игроков из хранилища
+    JsonResponse HandleGetRecords(records::RecordsRepository& repository, StringRequest&& request);
+
     class ApiHandler {
         app::Application& _application;
+        const RequestGuard& _guard;
+        const StrandMetrics& _strandMetrics;
         bool _disableTick;
 
         public:
         ApiHandler(const ApiHandler&) = delete;
         ApiHandler& operator=(const ApiHandler&) = delete;
 
-        ApiHandler(ApiHandler&& other) : _application (other._application), _disableTick {other._disableTick} {};
+        ApiHandler(ApiHandler&& other) :
+            _application (other._application), _guard {other._guard}, _strandMetrics {other._strandMetrics}, _disableTick {other._disableTick} {};
 
-        explicit ApiHandler(app::Application& app, bool disableTick) : _application {app}, _disableTick {disableTick} {};
+        explicit ApiHandler(app::Application& app, const RequestGuard& guard, const StrandMetrics& strandMetrics, bool disableTick) :
+            _application {app}, _guard {guard}, _strandMetrics {strandMetrics}, _disableTick {disableTick} {};
         
         bool IsApiRequest(std::string path) {
             return path.starts_with("/api/"s);
@@ -84,7 +151,9 @@ namespace http_handler {
         void operator()(http::request<Body, Allocator>&& request, ResponseWriter&& writer){
             std::string target = request.target();
 
-            if (target == "/api/v1/maps"s){
+            std::string path = target.substr(0, target.find('?'));
+
+            if (path == "/api/v1/maps"s){
                 auto response = HandleGetMaps(_application, std::move(request));
 
                 writer(response);
@@ -104,7 +173,7 @@ namespace http_handler {
                 return;
             }
 
-            if (request.target() == "/api/v1/game/join"s){
+            if (path == "/api/v1/game/join"s){
                 auto response = HandleJoinGame(_application, std::move(request));
 
                 writer(response);
@@ -112,7 +181,7 @@ namespace http_handler {
                 return;
             }
 
-            if (request.target() == "/api/v1/game/players"s){
+            if (path == "/api/v1/game/players"s){
                 auto response = HandleGetPlayers(_application, std::move(request));
 
                 writer(response);
@@ -120,7 +189,7 @@ namespace http_handler {
                 return;
             }
 
-            if (request.target() == "/api/v1/game/state"s){
+            if (path == "/api/v1/game/state"s){
                 auto response = HandleGetGameState(_application, std::move(request));
 
                 writer(response);
@@ -128,7 +197,7 @@ namespace http_handler {
                 return;
             }
 
-            if(request.target() == "/api/v1/game/player/action"s) {
+            if(path == "/api/v1/game/player/action"s) {
                 auto response = HandlePostPlayerAction(_application, std::move(request));
 
                 writer(response);
@@ -136,7 +205,15 @@ namespace http_handler {
                 return;
             }
 
-            if ((!_disableTick) && (request.target() == "/api/v1/game/tick"s)) {
+            if(path == "/api/v1/game/player/actions"s) {
+                auto response = HandlePostPlayerActions(_application, std::move(request));
+
+                writer(response);
+
+                return;
+            }
+
+            if ((!_disableTick) && (path == "/api/v1/game/tick"s)) {
                 auto response = HandlePostGameTick(_application, std::move(request));
 
                 writer(response);
@@ -144,6 +221,14 @@ namespace http_handler {
                 return;
             }
 
+            if (path == "/api/v1/metrics"s) {
+                auto response = HandleGetMetrics(_application, _guard, _strandMetrics, std::move(request));
+
+                writer(response);
+
+                return;
+            }
+
             // отправить BadRequest
             auto response = HandleBadRequest(std::move(request));
 
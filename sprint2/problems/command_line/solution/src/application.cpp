@@ -1,5 +1,4 @@
 #include <algorithm>
-#include <iostream>
 #include <ranges>
 #include <random>
 #include <utility>
@@ -12,56 +11,95 @@ namespace rv = rs::views;
 
 using namespace std::literals;
 
+// id карты не содержит '/', поэтому ключ однозначен при любом имени
+std::string PlayerKey(const model::Map::Id& mapId, const std::string& playerName) {
+    return *mapId + '/' + playerName;
+}
+
 Player Application::JoinGame(const std::string& playerName, const std::string& mapId) {
-    tokens::token_generator generator;
+    const auto id = model::Map::Id{mapId};
 
-    auto map = _game.FindMap(model::Map::Id{mapId});
+    // если игрок уже есть на этой карте - возвращаем что есть
+    if (auto known = _playerByName.find(PlayerKey(id, playerName)); known != _playerByName.end()) {
+        return *_players.Find(known->second);
+    }
 
-    model::Position spawnPoint = GetSpawnPoint(map);
+    // наименее заполненная сессия карты; если все заполнены - новая
+    auto& session = _game.PlaceNewPlayer(id);
 
-    if (auto session = _game.FindSessionByMapId(model::Map::Id{mapId})){
-        auto findResult = rs::find_if(_players, [playerName, &session](auto arg){return arg.name == playerName && arg.sessionId == session->GetId();}); 
-        
-        // если игрок есть - возвращаем что есть
-        if (findResult != _players.end()) {
-            return *findResult;
-        }
+    const auto spawnPoint = GetSpawnPoint(session);
+
+    const auto playerId = _players.PeekNextId();
+
+    auto& dog = session.AddDog(playerId, spawnPoint.position, spawnPoint.road);
+
+    auto& player = _players.Emplace(Player {playerId, playerName, session.GetId(), tokens::TokenGenerator::GenerateString(), dog.id});
+
+    player.joinTime = _gameTime;
+
+    if (auto retirementTime = _game.GetDogRetirementTime()) {
+        player.retirementTimer = _retirementTimers.Schedule(playerId, _gameTime + *retirementTime);
+    }
 
-        // если игрока нет в сессии
+    _playerByToken.emplace(player.token, playerId);
+    _playerByName.emplace(PlayerKey(id, playerName), playerId);
 
-        Player player {_players.size() +1, playerName, session->GetId(), generator.create()};
+    return player;
+}
 
-        session->AddDog(player.id, spawnPoint);
+bool Application::RemovePlayer(model::PlayerId playerId) {
+    auto player = _players.Find(playerId);
 
-        return _players.emplace_back(player);
+    if (!player) {
+        return false;
     }
 
-    // сессии нет - создаем
+    if (auto session = _game.GetSession(player->sessionId)) {
+        session->RemoveDog(player->dogId);
+
+        _playerByName.erase(PlayerKey(session->GetMapId(), player->name));
 
-    auto& session = _game.CreateSession(model::Map::Id{mapId});
+        if (session->GetDogs().empty()) {
+            _game.RemoveSession(session->GetId());
+        }
+    }
 
-    Player player {_players.size() +1, playerName, session.GetId(), generator.create()};
+    _playerByToken.erase(player->token);
 
-    session.AddDog(player.id, spawnPoint);
+    _retirementTimers.Cancel(player->retirementTimer);
 
-    return _players.emplace_back(player);
+    return _players.Erase(playerId);
 }
 
-std::vector<Player> Application::GetPlayersFromSession(int sessionId) {
-    auto result = _players | rs::views::filter([sessionId](auto arg){return arg.sessionId == sessionId;});
+std::vector<Player> Application::GetPlayersFromSession(model::SessionId sessionId) {
+    std::vector<Player> result;
+
+    auto session = _game.GetSession(sessionId);
+
+    if (!session) {
+        return result;
+    }
+
+    result.reserve(session->GetDogs().size());
 
-    return std::vector(result.begin(), result.end());
+    for (const auto& dog : session->GetDogs()) {
+        if (auto player = _players.Find(dog.playerId)) {
+            result.push_back(*player);
+        }
+    }
+
+    return result;
 }
 
 std::optional<Player> Application::FindPlayerByToken(const std::string& token){
-    auto player = rs::find_if(_players, [&token](auto arg) {return arg.token == token;});
+    auto playerId = _playerByToken.find(token);
 
-    if (player == _players.end())
+    if (playerId == _playerByToken.end())
     {
         return std::nullopt;
     }
 
-    return *player;
+    return *_players.Find(playerId->second);
 }
 
 void Application::Move(const Player& player, std::string move){
@@ -70,171 +108,190 @@ void Application::Move(const Player& player, std::string move){
     if (!session)
         return;
 
-    auto dog = session->GetDogByPlayerId(player.id);
+    auto dog = session->GetDog(player.dogId);
 
     if (!dog)
         return;
 
-    auto map = _game.FindMap(session->GetMapId());
+    // любое действие игрока откладывает его уход по бездействию
+    if (auto retirementTime = _game.GetDogRetirementTime()) {
+        _retirementTimers.Reschedule(player.retirementTimer, _gameTime + *retirementTime);
+    }
 
-    if (!map)
-        return;
+    // после перезагрузки карт сессия продолжает жить по своей карте
+    const auto* map = &session->GetMap();
 
     auto speed = map->GetDogSpeed().has_value() 
         ? map->GetDogSpeed().value() 
         : _game.GetDefaultDogSpeed();
 
+    const auto oldSpeed = dog->speed;
+    const auto oldDirection = dog->direction;
+
     if (move.empty())
     {
         dog->speed.vx = 0;
         dog->speed.vy = 0;
         dog->direction = model::NORTH;
-
-        return;
     }
-
-    if (move == "L"s){
+    else if (move == "L"s){
         dog->speed.vx = -1 * speed;
         dog->speed.vy = 0;
         dog->direction = model::WEST;
-
-        return;
     }
-
-    if (move == "R"s){
+    else if (move == "R"s){
         dog->speed.vx = speed;
         dog->speed.vy = 0;
         dog->direction = model::EAST;
-
-        return;
     }
-
-    if (move == "U"s){
+    else if (move == "U"s){
         dog->speed.vx = 0;
         dog->speed.vy = -1 * speed;
         dog->direction = model::NORTH;
-
-        return;
     }
-
-    if (move == "D"s) {
+    else if (move == "D"s) {
         dog->speed.vx = 0;
         dog->speed.vy = speed;
         dog->direction = model::SOUTH;
+    }
 
-        return;
+    if (dog->speed.vx != oldSpeed.vx || dog->speed.vy != oldSpeed.vy || dog->direction != oldDirection){
+        session->MarkChanged(*dog);
+    }
+}
+
+std::vector<bool> Application::MoveBatch(const std::vector<PlayerAction>& actions){
+    std::vector<bool> result;
+
+    result.reserve(actions.size());
+
+    for (const auto& action : actions){
+        auto player = FindPlayerByToken(action.token);
+
+        if (player){
+            Move(*player, action.move);
+        }
+
+        result.push_back(player.has_value());
     }
+
+    return result;
 }
 
 void Application::AddTime(int64_t timeDelta){
     auto& sessions = _game.GetSessions();
 
-    for(auto& session : sessions) {
-        auto& dogs = session.GetDogs();
+    const double seconds = timeDelta / 1000.0;
 
-        auto map = session.GetMapId();
+    for(auto& session : sessions) {
+        const auto& graph = session.GetMap().GetRoadGraph();
 
+        // стоящие собаки не обходятся вовсе: стоимость тика пропорциональна числу движущихся
+        session.ForEachActiveDog([&session, &graph, seconds](model::Dog& dog){
+            const auto oldCoord = dog.coord;
+            const auto oldSpeed = dog.speed;
 
-        for (auto& dog : dogs){
-            auto collisions = GetCollisionsAtPosition(dog.coord, map);
+            // перемещение считается аналитически: сколько бы ни длился тик,
+            // собака проходит по всем связанным дорогам до первой границы
+            MoveDog(dog, graph, seconds);
 
-            if (collisions.empty()){
-                std::cout << "add_time:" << dog.coord.x << " " << dog.coord.y << std::endl;
+            if (dog.coord.x != oldCoord.x || dog.coord.y != oldCoord.y
+                || dog.speed.vx != oldSpeed.vx || dog.speed.vy != oldSpeed.vy){
+                session.MarkChanged(dog);
             }
+        });
+    }
 
-            // расчет новой координаты по оси x
-            dog.coord.x += dog.speed.vx * (timeDelta / 1000.0);
+    _gameTime += timeDelta;
 
-            // проверка коллизий по x
-            auto xmin = rs::min(collisions | rv::transform(&Collision::x_min));
-            auto xmax = rs::max(collisions | rv::transform(&Collision::x_max));
+    RetireInactivePlayers();
 
-            if (dog.coord.x < xmin || dog.coord.x > xmax){
-                dog.coord.x = dog.coord.x < xmin ? xmin : xmax;
-                dog.speed.vx = 0;
-            }
+    for (const auto& handler : _tickHandlers){
+        handler(timeDelta);
+    }
+}
 
-            // расчет новой координаты по y
+void Application::RetireInactivePlayers(){
+    // все таймеры, истекшие за тик, срабатывают одной пачкой
+    const auto expired = _retirementTimers.Advance(_gameTime);
 
-            dog.coord.y += dog.speed.vy * (timeDelta / 1000.0);
+    if (expired.empty()){
+        return;
+    }
 
-            auto ymin = rs::min(collisions | rv::transform(&Collision::y_min));
-            auto ymax = rs::max(collisions | rv::transform(&Collision::y_max));
+    std::vector<RetiredPlayer> retired;
 
-            if (dog.coord.y < ymin || dog.coord.y > ymax){
-                dog.coord.y = dog.coord.y < ymin ? ymin : ymax;
-                dog.speed.vy = 0;
-            }
-        }
-    }
-}
+    retired.reserve(expired.size());
 
-/// 
-double GetD(model::Position a, model::Position b, model::Position p){
-    return (b.x - a.x) * (p.y - a.y) - (p.x - a.x) * (b.y - a.y);
-}
+    for (const auto playerId : expired){
+        auto player = _players.Find(playerId);
 
-std::vector<Collision> Application::GetCollisionsAtPosition(model::Position& position, model::Map::Id mapId){
-    auto roads = _game.FindMap(mapId)->GetRoads();
+        if (!player){
+            continue;
+        }
 
-    const auto delta = 0.4;
+        // таймер уже сработал и удален из колеса
+        player->retirementTimer = 0;
 
-    std::vector<Collision> result;
+        // очки снимаются с собаки до ее удаления
+        auto session = _game.GetSession(player->sessionId);
+        auto dog = session ? session->GetDog(player->dogId) : nullptr;
 
-    for(const auto& road: roads) {
-        auto x1 = std::min(road.GetStart().x, road.GetEnd().x) - delta;
-        auto x2 = std::max(road.GetStart().x, road.GetEnd().x) + delta;
-        auto y1 = std::min(road.GetStart().y, road.GetEnd().y) - delta;
-        auto y2 = std::max(road.GetStart().y, road.GetEnd().y) + delta;
+        retired.push_back({*player, dog ? dog->score : 0, static_cast<int64_t>(_gameTime - player->joinTime)});
 
-        std::vector<std::pair<model::Position, model::Position>> lines;
+        RemovePlayer(playerId);
+    }
 
-        // строим прямоугольник по часовой стрелке
-        lines.emplace_back(std::pair{model::Position{x1, y1}, model::Position{x1, y2}});
-        lines.emplace_back(std::pair{model::Position{x1, y2}, model::Position{x2, y2}});
-        lines.emplace_back(std::pair{model::Position{x2, y2}, model::Position{x2, y1}});
-        lines.emplace_back(std::pair{model::Position{x2, y1}, model::Position{x1, y1}});
+    for (const auto& handler : _retireHandlers){
+        handler(retired);
+    }
+}
 
-        // собака внутри прямоугольника, если все точки справа от граней (поскольку построение идет по часовой стрелке)
-        auto dogOnRoad = rs::all_of(lines, [&position](auto arg){ return GetD(arg.first, arg.second, position) <= 0;});
+Metrics Application::GetMetrics(){
+    Metrics metrics {};
 
-        if (dogOnRoad) {
-            result.emplace_back(Collision {x1,x2,y1,y2});
-        }
+    for (auto& session : _game.GetSessions()){
+        const size_t active = session.GetActiveDogCount();
+
+        metrics.activeDogs += active;
+        metrics.idleDogs += session.GetDogs().size() - active;
     }
 
-    return result;
+    return metrics;
 }
 
-model::Position Application::GetSpawnPoint(const model::Map* map){
+Application::SpawnPoint Application::GetSpawnPoint(model::GameSession& session){
+    const auto& map = session.GetMap();
+    const auto& graph = map.GetRoadGraph();
+
     if (!_randomizeSpawnPoints){
-        auto roadStart = map->GetRoads().at(0).GetStart();
+        auto roadStart = map.GetRoads().at(0).GetStart();
 
-        return model::Position { (double)roadStart.x, (double)roadStart.y};
+        return {model::Position { (double)roadStart.x, (double)roadStart.y}, graph.GetRoadOf(0)};
     }
 
-    auto roads = map->GetRoads();
+    const auto& roads = graph.GetRoads();
+    auto& random = session.GetRandom();
 
-    auto roadIndex = std::rand() % roads.size();
+    auto roadIndex = random.NextBelow(roads.size());
 
-    auto road = roads[roadIndex];
+    const auto& road = roads[roadIndex].road;
 
     int x, y = 0;
 
     if (road.IsHorizontal()){
         auto delta = std::abs(road.GetStart().x - road.GetEnd().x);
         auto initX = std::min(road.GetStart().x, road.GetEnd().x);
-        x = std::rand() % delta + initX;
+        x = static_cast<int>(random.NextBelow(delta + 1)) + initX;
         y = road.GetStart().y;
     }
-
-    if (road.IsVertical()){
+    else {
         auto delta = std::abs(road.GetStart().y - road.GetEnd().y);
         auto initY = std::min(road.GetStart().y, road.GetEnd().y);
         x = road.GetStart().x;
-        y = std::rand() % delta + initY;
+        y = static_cast<int>(random.NextBelow(delta + 1)) + initY;
     }
 
-    return model::Position{(double)x, (double)y};
+    return {model::Position{(double)x, (double)y}, roadIndex};
 }
 }
\ No newline at end of file
@@ -1,31 +1,77 @@
 #pragma once
+#include <functional>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include "model.h"
+#include "movement.h"
+#include "slot_map.h"
+#include "timer_wheel.h"
 
 namespace app {
     
     struct Player {
-        int id;
+        model::PlayerId id;
         std::string name;
-        int sessionId;
+        model::SessionId sessionId;
         std::string token;
+        model::DogId dogId;
+        // таймер ухода по бездействию, 0 - уход не настроен
+        TimerWheel::TimerId retirementTimer = 0;
+        // игровое время входа, мс
+        uint64_t joinTime = 0;
     };
 
-    struct Collision {
-        double x_min;
-        double x_max;
-        double y_min;
-        double y_max;
+    /// @brief Игрок, ушедший по бездействию, и его итог
+    struct RetiredPlayer {
+        Player player;
+        uint64_t score;
+        // время в игре, мс
+        int64_t playTime;
+    };
+
+    struct PlayerAction {
+        std::string token;
+        std::string move;
+    };
+
+    /// @brief Счетчики состояния игры для /api/v1/metrics
+    struct Metrics {
+        size_t activeDogs;
+        size_t idleDogs;
     };
 
     class Application {
-        std::vector<Player> _players;
+    public:
+        /// @brief Обработчик, вызываемый после каждого обновления состояния игры
+        using TickHandler = std::function<void(int64_t timeDelta)>;
+
+        /// @brief Обработчик ухода игроков по бездействию; игроки одного тика приходят одной пачкой
+        using RetireHandler = std::function<void(const std::vector<RetiredPlayer>& players)>;
+
+    private:
+        util::SlotMap<Player> _players;
+        std::unordered_map<std::string, model::PlayerId> _playerByToken;
+        // ключ - id карты и имя игрока, см. PlayerKey
+        std::unordered_map<std::string, model::PlayerId> _playerByName;
+        std::vector<TickHandler> _tickHandlers;
+        std::vector<RetireHandler> _retireHandlers;
+        // игровое время в миллисекундах и сроки ухода игроков по бездействию
+        uint64_t _gameTime = 0;
+        TimerWheel _retirementTimers;
         model::Game& _game;
         bool _randomizeSpawnPoints;
 
-        std::vector<Collision> GetCollisionsAtPosition(model::Position& position, model::Map::Id mapId);
-        model::Position GetSpawnPoint(const model::Map* map);
+        /// @brief Точка появления собаки и дорога графа, на которой она лежит
+        struct SpawnPoint {
+            model::Position position;
+            size_t road;
+        };
+
+        /// @brief Точка появления на карте сессии; случайные числа берутся из генератора сессии
+        SpawnPoint GetSpawnPoint(model::GameSession& session);
+
+        void RetireInactivePlayers();
 
         public:
         explicit Application(model::Game& game, bool randomizeSpawnPoints) : _game { game }, _randomizeSpawnPoints{randomizeSpawnPoints} {};
@@ -34,9 +80,12 @@ namespace app {
 
         std::optional<Player> FindPlayerByToken(const std::string& token);
 
-        std::vector<Player> GetPlayersFromSession(int sessionId);
+        std::vector<Player> GetPlayersFromSession(model::SessionId sessionId);
 
-        const model::Game::Maps GetMaps() const noexcept {
+        /// @brief Удалить игрока и его собаку за O(1); опустевшая сессия удаляется
+        bool RemovePlayer(model::PlayerId playerId);
+
+        const model::Game::Maps& GetMaps() const noexcept {
             return _game.GetMaps();
         }
 
@@ -46,12 +95,32 @@ namespace app {
             return _game.FindMap(mapId);
         }
 
-        model::GameSession* GetSession(int sessionId){
+        /// @brief Подменить карты загруженными из новой конфигурации, см. model::Game::ReplaceMaps.
+        /// Вызывается в strand приложения; загрузка выполняется заранее, вне него
+        void ReplaceMaps(model::Game&& loaded) {
+            _game.ReplaceMaps(std::move(loaded));
+        }
+
+        model::GameSession* GetSession(model::SessionId sessionId){
             return _game.GetSession(sessionId);
         }
 
         void Move(const Player& player, std::string move);
 
+        /// @brief Применить набор действий за один проход.
+        /// @return для каждого действия - найден ли игрок с указанным токеном
+        std::vector<bool> MoveBatch(const std::vector<PlayerAction>& actions);
+
         void AddTime(int64_t timeDelta);
+
+        Metrics GetMetrics();
+
+        void AddTickHandler(TickHandler handler) {
+            _tickHandlers.emplace_back(std::move(handler));
+        }
+
+        void AddRetireHandler(RetireHandler handler) {
+            _retireHandlers.emplace_back(std::move(handler));
+        }
     };
 }
\ No newline at end of file
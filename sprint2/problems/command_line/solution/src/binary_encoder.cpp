@@ -0,0 +1,182 @@
+#include "binary_encoder.h"
+
+#include <bit>
+#include <stdexcept>
+
+namespace binary {
+
+using namespace std::literals;
+
+// размер записи одной собаки в состоянии игры
+constexpr size_t DOG_RECORD_SIZE = sizeof(uint64_t) + 4 * sizeof(double) + sizeof(uint8_t);
+
+void Writer::F64(double value) {
+    static_assert(sizeof(double) == sizeof(uint64_t));
+
+    WriteLittleEndian(std::bit_cast<uint64_t>(value));
+}
+
+void Writer::String(std::string_view value) {
+    if (value.size() > UINT16_MAX) {
+        throw std::length_error("String is too long for binary encoding"s);
+    }
+
+    U16(static_cast<uint16_t>(value.size()));
+    _buffer.append(value);
+}
+
+std::string_view Reader::Take(size_t size) {
+    if (_data.size() - _offset < size) {
+        throw std::runtime_error("Unexpected end of binary data"s);
+    }
+
+    const auto bytes = _data.substr(_offset, size);
+
+    _offset += size;
+
+    return bytes;
+}
+
+uint8_t DirectionToChar(model::Direction direction) {
+    switch (direction) {
+    case model::NORTH:
+        return 'U';
+    case model::SOUTH:
+        return 'D';
+    case model::WEST:
+        return 'L';
+    case model::EAST:
+        return 'R';
+    }
+
+    return 'U';
+}
+
+void EncodeGameState(std::string& out, model::GameSession& session, std::optional<uint64_t> since) {
+    const bool full = !since || !session.CanDeltaFrom(*since);
+
+    auto& dogs = session.GetDogs();
+
+    auto changed = [full, &since](const model::Dog& dog) {
+        return full || dog.version > *since;
+    };
+
+    const auto count = static_cast<uint32_t>(rs::count_if(dogs, changed));
+
+    out.reserve(out.size() + sizeof(uint64_t) + sizeof(uint8_t) + sizeof(uint32_t) + count * DOG_RECORD_SIZE);
+
+    Writer writer {out};
+
+    writer.U64(session.GetVersion());
+    writer.U8(full ? 1 : 0);
+    writer.U32(count);
+
+    for (const auto& dog : dogs) {
+        if (!changed(dog)) {
+            continue;
+        }
+
+        writer.U64(dog.playerId);
+        writer.F64(dog.coord.x);
+        writer.F64(dog.coord.y);
+        writer.F64(dog.speed.vx);
+        writer.F64(dog.speed.vy);
+        writer.U8(DirectionToChar(dog.direction));
+    }
+}
+
+GameState DecodeGameState(Reader& reader) {
+    GameState state;
+
+    state.version = reader.U64();
+    state.full = reader.U8() != 0;
+
+    // число записей не используется для reserve: в обрезанных данных оно может быть любым
+    for (uint32_t count = reader.U32(); count > 0; --count) {
+        auto& dog = state.dogs.emplace_back();
+
+        dog.playerId = reader.U64();
+        dog.coord = {reader.F64(), reader.F64()};
+        dog.speed = {reader.F64(), reader.F64()};
+        dog.direction = static_cast<char>(reader.U8());
+    }
+
+    return state;
+}
+
+void EncodeMap(std::string& out, const model::Map& map) {
+    Writer writer {out};
+
+    writer.String(*map.GetId());
+    writer.String(map.GetName());
+
+    writer.U32(static_cast<uint32_t>(map.GetRoads().size()));
+
+    for (const auto& road : map.GetRoads()) {
+        writer.U8(road.IsHorizontal() ? 'H' : 'V');
+        writer.I32(road.GetStart().x);
+        writer.I32(road.GetStart().y);
+        writer.I32(road.IsHorizontal() ? road.GetEnd().x : road.GetEnd().y);
+    }
+
+    writer.U32(static_cast<uint32_t>(map.GetBuildings().size()));
+
+    for (const auto& building : map.GetBuildings()) {
+        const auto& bounds = building.GetBounds();
+
+        writer.I32(bounds.position.x);
+        writer.I32(bounds.position.y);
+        writer.I32(bounds.size.width);
+        writer.I32(bounds.size.height);
+    }
+
+    writer.U32(static_cast<uint32_t>(map.GetOffices().size()));
+
+    for (const auto& office : map.GetOffices()) {
+        writer.String(*office.GetId());
+        writer.I32(office.GetPosition().x);
+        writer.I32(office.GetPosition().y);
+        writer.I32(office.GetOffset().dx);
+        writer.I32(office.GetOffset().dy);
+    }
+}
+
+model::Map DecodeMap(Reader& reader) {
+    auto id = model::Map::Id {std::string {reader.String()}};
+    auto name = std::string {reader.String()};
+
+    model::Map map {std::move(id), std::move(name)};
+
+    for (uint32_t count = reader.U32(); count > 0; --count) {
+        const auto orientation = reader.U8();
+        const model::Point start {reader.I32(), reader.I32()};
+        const auto end = reader.I32();
+
+        if (orientation == 'H') {
+            map.AddRoad(model::Road {model::Road::HORIZONTAL, start, end});
+        } else if (orientation == 'V') {
+            map.AddRoad(model::Road {model::Road::VERTICAL, start, end});
+        } else {
+            throw std::runtime_error("Unknown road orientation in binary data"s);
+        }
+    }
+
+    for (uint32_t count = reader.U32(); count > 0; --count) {
+        const model::Point position {reader.I32(), reader.I32()};
+        const model::Size size {reader.I32(), reader.I32()};
+
+        map.AddBuilding(model::Building {model::Rectangle {position, size}});
+    }
+
+    for (uint32_t count = reader.U32(); count > 0; --count) {
+        auto officeId = model::Office::Id {std::string {reader.String()}};
+        const model::Point position {reader.I32(), reader.I32()};
+        const model::Offset offset {reader.I32(), reader.I32()};
+
+        map.AddOffice(model::Office {std::move(officeId), position, offset});
+    }
+
+    return map;
+}
+
+}  // namespace binary
@@ -0,0 +1,168 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "model.h"
+
+/*
+ * Компактное двоичное представление состояния игры и карт.
+ * Все числа записываются в little-endian, строки - длина uint16 и байты.
+ *
+ * Состояние игры:
+ *   uint64 version, uint8 full, uint32 count,
+ *   count * { uint64 playerId, float64 x, float64 y, float64 vx, float64 vy, uint8 dir ('U','D','L','R') }
+ *
+ * Карта:
+ *   string id, string name,
+ *   uint32 roads * { uint8 orientation ('H','V'), int32 x0, int32 y0, int32 x1 или y1 },
+ *   uint32 buildings * { int32 x, int32 y, int32 w, int32 h },
+ *   uint32 offices * { string id, int32 x, int32 y, int32 offsetX, int32 offsetY }
+ */
+namespace binary {
+
+inline constexpr std::string_view CONTENT_TYPE = "application/octet-stream";
+
+/// @brief Запись значений в конец буфера без промежуточных объектов
+class Writer {
+    std::string& _buffer;
+
+    public:
+    explicit Writer(std::string& buffer) : _buffer {buffer} {};
+
+    void U8(uint8_t value) {
+        _buffer.push_back(static_cast<char>(value));
+    }
+
+    void U16(uint16_t value) {
+        WriteLittleEndian(value);
+    }
+
+    void U32(uint32_t value) {
+        WriteLittleEndian(value);
+    }
+
+    void I32(int32_t value) {
+        WriteLittleEndian(static_cast<uint32_t>(value));
+    }
+
+    void U64(uint64_t value) {
+        WriteLittleEndian(value);
+    }
+
+    void F64(double value);
+
+    void String(std::string_view value);
+
+    private:
+    template <typename T>
+    void WriteLittleEndian(T value) {
+        char bytes[sizeof(T)];
+
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(bytes, &value, sizeof(T));
+        } else {
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+            }
+        }
+
+        _buffer.append(bytes, sizeof(T));
+    }
+};
+
+/// @brief Чтение значений, записанных Writer. При нехватке данных бросает std::runtime_error
+class Reader {
+    std::string_view _data;
+    size_t _offset = 0;
+
+    public:
+    explicit Reader(std::string_view data) : _data {data} {};
+
+    uint8_t U8() {
+        return static_cast<uint8_t>(Take(1)[0]);
+    }
+
+    uint16_t U16() {
+        return ReadLittleEndian<uint16_t>();
+    }
+
+    uint32_t U32() {
+        return ReadLittleEndian<uint32_t>();
+    }
+
+    int32_t I32() {
+        return static_cast<int32_t>(ReadLittleEndian<uint32_t>());
+    }
+
+    uint64_t U64() {
+        return ReadLittleEndian<uint64_t>();
+    }
+
+    double F64() {
+        return std::bit_cast<double>(ReadLittleEndian<uint64_t>());
+    }
+
+    std::string_view String() {
+        return Take(U16());
+    }
+
+    bool AtEnd() const noexcept {
+        return _offset == _data.size();
+    }
+
+    private:
+    std::string_view Take(size_t size);
+
+    template <typename T>
+    T ReadLittleEndian() {
+        const auto bytes = Take(sizeof(T));
+
+        T value;
+
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(&value, bytes.data(), sizeof(T));
+        } else {
+            value = 0;
+
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                value |= static_cast<T>(static_cast<uint8_t>(bytes[i])) << (8 * i);
+            }
+        }
+
+        return value;
+    }
+};
+
+/// @brief Запись одной собаки в состоянии игры
+struct DogState {
+    uint64_t playerId;
+    model::Position coord;
+    model::Speed speed;
+    // 'U', 'D', 'L' или 'R'
+    char direction;
+};
+
+/// @brief Состояние игры в том виде, как его видит клиент
+struct GameState {
+    uint64_t version;
+    // true - полный снимок, false - только изменившиеся собаки
+    bool full;
+    std::vector<DogState> dogs;
+};
+
+/// @brief Состояние сессии: полный снимок или изменения после версии since
+void EncodeGameState(std::string& out, model::GameSession& session, std::optional<uint64_t> since);
+
+/// @brief Состояние в формате EncodeGameState
+GameState DecodeGameState(Reader& reader);
+
+void EncodeMap(std::string& out, const model::Map& map);
+
+/// @brief Карта в формате EncodeMap (без скорости собак и размера сессии)
+model::Map DecodeMap(Reader& reader);
+
+}  // namespace binary
@@ -0,0 +1,724 @@
+#include "config_parser.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <boost/json/basic_parser_impl.hpp>
+#include "road_graph.h"
+
+namespace json_loader {
+
+namespace json = boost::json;
+namespace sys = boost::system;
+
+using namespace std::literals;
+
+ConfigError::ConfigError(const std::string& message, size_t line, size_t column) :
+    std::runtime_error {message + " (строка "s + std::to_string(line) + ", столбец "s + std::to_string(column) + ")"s},
+    _line {line},
+    _column {column} {};
+
+namespace {
+
+// размер блока, которым читается файл
+constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+// целочисленные поля дороги, здания и офиса
+constexpr std::array<std::string_view, 4> ROAD_FIELDS {"x0"sv, "y0"sv, "x1"sv, "y1"sv};
+constexpr std::array<std::string_view, 4> BUILDING_FIELDS {"x"sv, "y"sv, "w"sv, "h"sv};
+constexpr std::array<std::string_view, 4> OFFICE_FIELDS {"x"sv, "y"sv, "offsetX"sv, "offsetY"sv};
+
+/// @brief Позиция в тексте, строка и столбец с 1
+struct TextPosition {
+    size_t line = 1;
+    size_t column = 1;
+
+    void Advance(std::string_view text) noexcept {
+        for (char c : text) {
+            if (c == '\n') {
+                ++line;
+                column = 1;
+            } else {
+                ++column;
+            }
+        }
+    }
+};
+
+/// @brief Обработчик событий basic_parser: проверяет поля и строит игру по мере разбора.
+/// Текущий путь в документе хранится стеком контекстов, значения неизвестных ключей пропускаются.
+class GameHandler {
+public:
+    static constexpr size_t max_object_size = std::numeric_limits<size_t>::max();
+    static constexpr size_t max_array_size = std::numeric_limits<size_t>::max();
+    static constexpr size_t max_key_size = std::numeric_limits<size_t>::max();
+    static constexpr size_t max_string_size = std::numeric_limits<size_t>::max();
+
+    explicit GameHandler(model::Game& game) : _game {game} {};
+
+    /// @brief Сообщение об ошибке проверки, пустое - ошибка синтаксиса JSON
+    const std::string& GetError() const noexcept {
+        return _error;
+    }
+
+    bool on_document_begin(sys::error_code&) {
+        return true;
+    }
+
+    bool on_document_end(sys::error_code&) {
+        return true;
+    }
+
+    bool on_object_begin(sys::error_code& ec);
+
+    bool on_object_end(size_t, sys::error_code& ec);
+
+    bool on_array_begin(sys::error_code& ec);
+
+    bool on_array_end(size_t, sys::error_code&);
+
+    bool on_key_part(json::string_view part, size_t size, sys::error_code&) {
+        Accumulate(_key, part, size);
+        return true;
+    }
+
+    bool on_key(json::string_view part, size_t size, sys::error_code&) {
+        Accumulate(_key, part, size);
+        return true;
+    }
+
+    bool on_string_part(json::string_view part, size_t size, sys::error_code&) {
+        if (_stack.back() != Context::Skip) {
+            Accumulate(_string, part, size);
+        }
+        return true;
+    }
+
+    bool on_string(json::string_view part, size_t size, sys::error_code& ec);
+
+    bool on_number_part(json::string_view, sys::error_code&) {
+        return true;
+    }
+
+    bool on_int64(int64_t value, json::string_view, sys::error_code& ec) {
+        return OnNumber(static_cast<double>(value), value, ec);
+    }
+
+    bool on_uint64(uint64_t value, json::string_view, sys::error_code& ec) {
+        // вызывается только для чисел больше INT64_MAX
+        return OnNumber(static_cast<double>(value), std::nullopt, ec);
+    }
+
+    bool on_double(double value, json::string_view, sys::error_code& ec) {
+        return OnNumber(value, std::nullopt, ec);
+    }
+
+    bool on_bool(bool, sys::error_code& ec) {
+        return OnOther(ec);
+    }
+
+    bool on_null(sys::error_code& ec) {
+        return OnOther(ec);
+    }
+
+    bool on_comment_part(json::string_view, sys::error_code&) {
+        return true;
+    }
+
+    bool on_comment(json::string_view, sys::error_code&) {
+        return true;
+    }
+
+private:
+    enum class Context {
+        Document,
+        Root,
+        Maps,
+        Map,
+        Roads,
+        Road,
+        Buildings,
+        Building,
+        Offices,
+        Office,
+        // значение неизвестного ключа
+        Skip
+    };
+
+    enum class ValueType {
+        Number,
+        Integer,
+        String,
+        Array
+    };
+
+    /// @brief Разбираемая карта: Map создается, когда известны id и name
+    struct MapDraft {
+        std::optional<std::string> id;
+        std::optional<std::string> name;
+        std::optional<double> dogSpeed;
+        std::optional<size_t> sessionCapacity;
+        std::optional<model::Map::Roads> roads;
+        std::optional<model::Map::Buildings> buildings;
+        std::optional<model::Map::Offices> offices;
+    };
+
+    model::Game& _game;
+    std::vector<Context> _stack {Context::Document};
+    // глубина вложенности пропускаемого значения
+    size_t _skipDepth = 0;
+    std::string _key;
+    std::string _string;
+    std::string _error;
+    std::optional<MapDraft> _map;
+    // поля текущей дороги, здания или офиса в порядке ROAD_FIELDS, BUILDING_FIELDS, OFFICE_FIELDS
+    std::array<std::optional<int>, 4> _fields;
+    std::optional<std::string> _officeId;
+
+    /// @brief Ключи и строки приходят частями, size - длина с учетом всех частей
+    static void Accumulate(std::string& out, json::string_view part, size_t size) {
+        if (size == part.size()) {
+            out.clear();
+        }
+
+        out.append(part.data(), part.size());
+    }
+
+    static const std::array<std::string_view, 4>* GetFields(Context context) noexcept {
+        switch (context) {
+        case Context::Road:
+            return &ROAD_FIELDS;
+        case Context::Building:
+            return &BUILDING_FIELDS;
+        case Context::Office:
+            return &OFFICE_FIELDS;
+        default:
+            return nullptr;
+        }
+    }
+
+    /// @brief Ожидаемый тип значения ключа key в контексте context, nullopt - ключ неизвестен
+    static std::optional<ValueType> GetExpectedType(Context context, std::string_view key) noexcept;
+
+    static std::string_view GetTypeName(ValueType type) noexcept {
+        switch (type) {
+        case ValueType::Number:
+            return "число"sv;
+        case ValueType::Integer:
+            return "целое число"sv;
+        case ValueType::String:
+            return "строка"sv;
+        case ValueType::Array:
+            return "массив"sv;
+        }
+
+        return {};
+    }
+
+    static bool IsArrayContext(Context context) noexcept {
+        return context == Context::Maps || context == Context::Roads
+            || context == Context::Buildings || context == Context::Offices;
+    }
+
+    bool Fail(std::string message, sys::error_code& ec) {
+        _error = std::move(message);
+        ec = sys::errc::make_error_code(sys::errc::invalid_argument);
+        return false;
+    }
+
+    bool FailType(ValueType expected, sys::error_code& ec) {
+        return Fail("Поле "s + _key + ": ожидается "s + std::string{GetTypeName(expected)}, ec);
+    }
+
+    /// @brief Значение, которое не может быть элементом массива или корнем документа
+    bool FailElement(sys::error_code& ec) {
+        if (_stack.back() == Context::Document) {
+            return Fail("Конфигурация должна быть объектом"s, ec);
+        }
+
+        return Fail("Элементы массива должны быть объектами"s, ec);
+    }
+
+    /// @brief Скаляр, не являющийся числом или строкой
+    bool OnOther(sys::error_code& ec);
+
+    bool OnNumber(double value, std::optional<int64_t> integer, sys::error_code& ec);
+
+    bool SetNumber(double value, sys::error_code& ec);
+
+    bool SetInteger(int64_t value, sys::error_code& ec);
+
+    bool SetString(sys::error_code& ec);
+
+    bool FinishRoad(sys::error_code& ec);
+
+    bool FinishBuilding(sys::error_code& ec);
+
+    bool FinishOffice(sys::error_code& ec);
+
+    bool FinishMap(sys::error_code& ec);
+};
+
+std::optional<GameHandler::ValueType> GameHandler::GetExpectedType(Context context, std::string_view key) noexcept {
+    switch (context) {
+    case Context::Root:
+        if (key == "defaultDogSpeed"sv || key == "dogRetirementTime"sv) {
+            return ValueType::Number;
+        }
+        if (key == "defaultSessionCapacity"sv) {
+            return ValueType::Integer;
+        }
+        if (key == "maps"sv) {
+            return ValueType::Array;
+        }
+        break;
+    case Context::Map:
+        if (key == "id"sv || key == "name"sv) {
+            return ValueType::String;
+        }
+        if (key == "dogSpeed"sv) {
+            return ValueType::Number;
+        }
+        if (key == "sessionCapacity"sv) {
+            return ValueType::Integer;
+        }
+        if (key == "roads"sv || key == "buildings"sv || key == "offices"sv) {
+            return ValueType::Array;
+        }
+        break;
+    case Context::Office:
+        if (key == "id"sv) {
+            return ValueType::String;
+        }
+        [[fallthrough]];
+    case Context::Road:
+    case Context::Building:
+        if (std::ranges::find(*GetFields(context), key) != GetFields(context)->end()) {
+            return ValueType::Integer;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return std::nullopt;
+}
+
+bool GameHandler::on_object_begin(sys::error_code& ec) {
+    switch (_stack.back()) {
+    case Context::Skip:
+        ++_skipDepth;
+        return true;
+    case Context::Document:
+        _stack.push_back(Context::Root);
+        return true;
+    case Context::Maps:
+        _map.emplace();
+        _stack.push_back(Context::Map);
+        return true;
+    case Context::Roads:
+        _fields = {};
+        _stack.push_back(Context::Road);
+        return true;
+    case Context::Buildings:
+        _fields = {};
+        _stack.push_back(Context::Building);
+        return true;
+    case Context::Offices:
+        _fields = {};
+        _officeId.reset();
+        _stack.push_back(Context::Office);
+        return true;
+    default:
+        break;
+    }
+
+    // ни один известный ключ не ожидает объект
+    if (auto expected = GetExpectedType(_stack.back(), _key)) {
+        return FailType(*expected, ec);
+    }
+
+    _skipDepth = 1;
+    _stack.push_back(Context::Skip);
+
+    return true;
+}
+
+bool GameHandler::on_object_end(size_t, sys::error_code& ec) {
+    const auto context = _stack.back();
+
+    if (context == Context::Skip) {
+        if (--_skipDepth == 0) {
+            _stack.pop_back();
+        }
+
+        return true;
+    }
+
+    _stack.pop_back();
+
+    switch (context) {
+    case Context::Road:
+        return FinishRoad(ec);
+    case Context::Building:
+        return FinishBuilding(ec);
+    case Context::Office:
+        return FinishOffice(ec);
+    case Context::Map:
+        return FinishMap(ec);
+    default:
+        return true;
+    }
+}
+
+bool GameHandler::on_array_begin(sys::error_code& ec) {
+    const auto context = _stack.back();
+
+    if (context == Context::Skip) {
+        ++_skipDepth;
+        return true;
+    }
+
+    if (context == Context::Document || IsArrayContext(context)) {
+        return FailElement(ec);
+    }
+
+    const auto expected = GetExpectedType(context, _key);
+
+    if (!expected) {
+        _skipDepth = 1;
+        _stack.push_back(Context::Skip);
+
+        return true;
+    }
+
+    if (*expected != ValueType::Array) {
+        return FailType(*expected, ec);
+    }
+
+    if (context == Context::Root) {
+        _stack.push_back(Context::Maps);
+    } else if (_key == "roads"sv) {
+        _map->roads.emplace();
+        _stack.push_back(Context::Roads);
+    } else if (_key == "buildings"sv) {
+        _map->buildings.emplace();
+        _stack.push_back(Context::Buildings);
+    } else {
+        _map->offices.emplace();
+        _stack.push_back(Context::Offices);
+    }
+
+    return true;
+}
+
+bool GameHandler::on_array_end(size_t, sys::error_code&) {
+    if (_stack.back() == Context::Skip && --_skipDepth != 0) {
+        return true;
+    }
+
+    _stack.pop_back();
+
+    return true;
+}
+
+bool GameHandler::on_string(json::string_view part, size_t size, sys::error_code& ec) {
+    const auto context = _stack.back();
+
+    if (context == Context::Skip) {
+        return true;
+    }
+
+    if (context == Context::Document || IsArrayContext(context)) {
+        return FailElement(ec);
+    }
+
+    Accumulate(_string, part, size);
+
+    const auto expected = GetExpectedType(context, _key);
+
+    if (!expected) {
+        return true;
+    }
+
+    if (*expected != ValueType::String) {
+        return FailType(*expected, ec);
+    }
+
+    return SetString(ec);
+}
+
+bool GameHandler::OnOther(sys::error_code& ec) {
+    const auto context = _stack.back();
+
+    if (context == Context::Skip) {
+        return true;
+    }
+
+    if (context == Context::Document || IsArrayContext(context)) {
+        return FailElement(ec);
+    }
+
+    if (auto expected = GetExpectedType(context, _key)) {
+        return FailType(*expected, ec);
+    }
+
+    return true;
+}
+
+bool GameHandler::OnNumber(double value, std::optional<int64_t> integer, sys::error_code& ec) {
+    const auto context = _stack.back();
+
+    if (context == Context::Skip) {
+        return true;
+    }
+
+    if (context == Context::Document || IsArrayContext(context)) {
+        return FailElement(ec);
+    }
+
+    const auto expected = GetExpectedType(context, _key);
+
+    if (!expected) {
+        return true;
+    }
+
+    if (*expected == ValueType::Number) {
+        return SetNumber(value, ec);
+    }
+
+    // целое значение, записанное как 5.0, тоже допустимо
+    if (!integer && std::trunc(value) == value
+        && value >= static_cast<double>(std::numeric_limits<int64_t>::min())
+        && value < static_cast<double>(std::numeric_limits<int64_t>::max())) {
+        integer = static_cast<int64_t>(value);
+    }
+
+    if (*expected != ValueType::Integer || !integer) {
+        return FailType(*expected, ec);
+    }
+
+    return SetInteger(*integer, ec);
+}
+
+bool GameHandler::SetNumber(double value, sys::error_code& ec) {
+    if (_stack.back() == Context::Map) {
+        _map->dogSpeed = value;
+
+        return true;
+    }
+
+    if (_key == "defaultDogSpeed"sv) {
+        _game.SetDefaultDogSpeed(value);
+
+        return true;
+    }
+
+    if (value <= 0) {
+        return Fail("dogRetirementTime должно быть положительным числом"s, ec);
+    }
+
+    // в конфигурации время в секундах, игровое время - в миллисекундах
+    _game.SetDogRetirementTime(std::llround(value * 1000));
+
+    return true;
+}
+
+bool GameHandler::SetInteger(int64_t value, sys::error_code& ec) {
+    const auto context = _stack.back();
+
+    if (context == Context::Root || context == Context::Map) {
+        if (value < 1) {
+            return Fail("Размер сессии должен быть целым числом больше 0"s, ec);
+        }
+
+        if (context == Context::Root) {
+            _game.SetDefaultSessionCapacity(static_cast<size_t>(value));
+        } else {
+            _map->sessionCapacity = static_cast<size_t>(value);
+        }
+
+        return true;
+    }
+
+    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+        return Fail("Поле "s + _key + ": значение вне допустимого диапазона"s, ec);
+    }
+
+    const auto& fields = *GetFields(context);
+
+    _fields[std::ranges::find(fields, _key) - fields.begin()] = static_cast<int>(value);
+
+    return true;
+}
+
+bool GameHandler::SetString(sys::error_code&) {
+    if (_stack.back() == Context::Office) {
+        _officeId = _string;
+    } else if (_key == "id"sv) {
+        _map->id = _string;
+    } else {
+        _map->name = _string;
+    }
+
+    return true;
+}
+
+bool GameHandler::FinishRoad(sys::error_code& ec) {
+    const auto& [x0, y0, x1, y1] = _fields;
+
+    if (!x0 || !y0 || (!x1 && !y1)) {
+        return Fail("Дорога должна содержать поля x0, y0 и x1 или y1"s, ec);
+    }
+
+    if (x1) {
+        _map->roads->emplace_back(model::Road::HORIZONTAL, model::Point{*x0, *y0}, *x1);
+    } else {
+        _map->roads->emplace_back(model::Road::VERTICAL, model::Point{*x0, *y0}, *y1);
+    }
+
+    return true;
+}
+
+bool GameHandler::FinishBuilding(sys::error_code& ec) {
+    const auto& [x, y, w, h] = _fields;
+
+    if (!x || !y || !w || !h) {
+        return Fail("Здание должно содержать поля x, y, w, h"s, ec);
+    }
+
+    _map->buildings->emplace_back(model::Rectangle{model::Point{*x, *y}, model::Size{*w, *h}});
+
+    return true;
+}
+
+bool GameHandler::FinishOffice(sys::error_code& ec) {
+    const auto& [x, y, offsetX, offsetY] = _fields;
+
+    if (!_officeId || !x || !y || !offsetX || !offsetY) {
+        return Fail("Офис должен содержать поля id, x, y, offsetX, offsetY"s, ec);
+    }
+
+    _map->offices->emplace_back(model::Office::Id{std::move(*_officeId)}, model::Point{*x, *y}, model::Offset{*offsetX, *offsetY});
+
+    return true;
+}
+
+bool GameHandler::FinishMap(sys::error_code& ec) {
+    auto& draft = *_map;
+
+    for (auto [present, field] : {
+            std::pair{draft.id.has_value(), "id"sv},
+            std::pair{draft.name.has_value(), "name"sv},
+            std::pair{draft.roads.has_value(), "roads"sv},
+            std::pair{draft.buildings.has_value(), "buildings"sv},
+            std::pair{draft.offices.has_value(), "offices"sv}}) {
+        if (!present) {
+            return Fail("Карта должна содержать поле "s + std::string{field}, ec);
+        }
+    }
+
+    model::Map map {model::Map::Id{std::move(*draft.id)}, std::move(*draft.name)};
+
+    for (const auto& road : *draft.roads) {
+        map.AddRoad(road);
+    }
+
+    for (const auto& building : *draft.buildings) {
+        map.AddBuilding(building);
+    }
+
+    for (auto&& office : *draft.offices) {
+        map.AddOffice(std::move(office));
+    }
+
+    if (draft.dogSpeed) {
+        map.SetDogSpeed(*draft.dogSpeed);
+    }
+
+    if (draft.sessionCapacity) {
+        map.SetSessionCapacity(*draft.sessionCapacity);
+    }
+
+    _map.reset();
+
+    try {
+        // граф дорог строится один раз при загрузке, движение и появление собак используют только его
+        map.SetRoadGraph(std::make_shared<const model::RoadGraph>(map.GetRoads()));
+
+        _game.AddMap(std::move(map));
+    } catch (const std::exception& e) {
+        // исключения не должны проходить через basic_parser
+        return Fail(e.what(), ec);
+    }
+
+    return true;
+}
+
+}  // namespace
+
+model::Game ParseGame(std::istream& input) {
+    model::Game game;
+
+    json::basic_parser<GameHandler> parser {json::parse_options{}, game};
+
+    TextPosition position;
+    std::string chunk(CHUNK_SIZE, '\0');
+
+    auto error = [&parser, &position](const sys::error_code& ec) {
+        const auto& message = parser.handler().GetError();
+
+        return ConfigError {message.empty() ? "Ошибка синтаксиса JSON: "s + ec.message() : message, position.line, position.column};
+    };
+
+    bool more = true;
+
+    while (more) {
+        input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+
+        if (input.bad()) {
+            throw std::runtime_error("Не удалось прочитать файл с конфигурацией"s);
+        }
+
+        more = input.good();
+
+        std::string_view data {chunk.data(), static_cast<size_t>(input.gcount())};
+
+        if (!parser.done()) {
+            sys::error_code ec;
+
+            const auto consumed = parser.write_some(more, data.data(), data.size(), ec);
+
+            position.Advance(data.substr(0, consumed));
+
+            if (ec) {
+                throw error(ec);
+            }
+
+            data.remove_prefix(consumed);
+        }
+
+        // после документа допустимы только пробельные символы
+        const auto extra = data.find_first_not_of(" \t\r\n"sv);
+
+        if (extra != std::string_view::npos) {
+            position.Advance(data.substr(0, extra));
+
+            throw ConfigError {"Лишние данные после конфигурации"s, position.line, position.column};
+        }
+
+        position.Advance(data);
+    }
+
+    if (!parser.done()) {
+        throw ConfigError {"Неожиданный конец файла конфигурации"s, position.line, position.column};
+    }
+
+    return game;
+}
+
+}  // namespace json_loader
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include "model.h"
+
+namespace json_loader {
+
+/// @brief Ошибка в файле конфигурации: синтаксис JSON или недопустимое значение поля.
+/// Строка и столбец считаются с 1 и указывают место, где разбор остановился
+class ConfigError : public std::runtime_error {
+public:
+    ConfigError(const std::string& message, size_t line, size_t column);
+
+    size_t GetLine() const noexcept {
+        return _line;
+    }
+
+    size_t GetColumn() const noexcept {
+        return _column;
+    }
+
+private:
+    size_t _line;
+    size_t _column;
+};
+
+/// @brief Потоковый разбор конфигурации игры (SAX, boost::json::basic_parser).
+/// Файл читается блоками, карта строится прямо во время чтения и после закрывающей
+/// скобки сразу добавляется в игру, поэтому в памяти одновременно находится одна карта.
+/// Поля проверяются по мере чтения, неизвестные ключи пропускаются.
+/// @throw ConfigError с позицией ошибки
+model::Game ParseGame(std::istream& input);
+
+}  // namespace json_loader
@@ -25,7 +25,7 @@ struct ErrorDto {
 /// @brief DTO для токена авторизации
 struct AuthTokenDto {
     std::string AuthToken;
-    int PlayerId;
+    model::PlayerId PlayerId;
 }; //struct AuthTokenDto
 
 } // namespace dto
\ No newline at end of file
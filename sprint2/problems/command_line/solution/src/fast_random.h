@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+
+namespace util {
+
+/**
+ * Быстрый генератор псевдослучайных чисел xoshiro256++.
+ * Состояние - 32 байта, шаг - несколько сдвигов и сложений, поэтому вызов встраивается
+ * в место использования. Генератор не потокобезопасен: у каждой игровой сессии свой,
+ * и одинаковое зерно дает одинаковую последовательность.
+ *
+ * Удовлетворяет UniformRandomBitGenerator и подходит для распределений <random>.
+ */
+class FastRandom {
+public:
+    using result_type = uint64_t;
+
+    explicit FastRandom(uint64_t seed = 0) noexcept {
+        Seed(seed);
+    }
+
+    /// @brief Заполнить состояние из зерна через splitmix64: состояние не бывает нулевым
+    void Seed(uint64_t seed) noexcept {
+        for (auto& word : _state) {
+            word = SplitMix64(seed);
+        }
+    }
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+
+    static constexpr result_type max() noexcept {
+        return UINT64_MAX;
+    }
+
+    result_type operator()() noexcept {
+        const uint64_t result = RotateLeft(_state[0] + _state[3], 23) + _state[0];
+        const uint64_t t = _state[1] << 17;
+
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = RotateLeft(_state[3], 45);
+
+        return result;
+    }
+
+    /// @brief Число в [0, 1) из старших 53 бит
+    double NextDouble() noexcept {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    /// @brief Число в [0, bound) умножением вместо деления (метод Лемира без отбраковки:
+    /// смещение не больше bound / 2^64)
+    uint64_t NextBelow(uint64_t bound) noexcept {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>((*this)()) * bound) >> 64);
+    }
+
+    /// @brief Шаг splitmix64: перемешивает state и продвигает его. Годится и для того,
+    /// чтобы получать независимые зерна из одного общего
+    static uint64_t SplitMix64(uint64_t& state) noexcept {
+        uint64_t z = (state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t _state[4];
+
+    static uint64_t RotateLeft(uint64_t x, int k) noexcept {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+}  // namespace util
@@ -58,6 +58,10 @@ namespace http_server {
         return request_;
     }
 
+    tcp::socket SessionBase::ReleaseSocket() {
+        return stream_.release_socket();
+    }
+
     void SessionBase::OnWrite(bool keep_alive, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written)
     {
         if (ec)
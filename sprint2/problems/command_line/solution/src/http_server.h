@@ -1,13 +1,16 @@
 #pragma once
 #include "sdk.h"
 //
+#include <boost/asio/dispatch.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/json.hpp>
 #include <chrono>
+#include <optional>
 #include "logger.h"
+#include "websocket_session.h"
 
 namespace json = boost::json;
 namespace logs = boost::log;
@@ -44,6 +47,9 @@ protected:
 
     const HttpRequest& GetRequest() const;
 
+    // Передать сокет другому владельцу (например, WebSocket-сессии)
+    tcp::socket ReleaseSocket();
+
     template <typename Body, typename Fields>
     void Write(http::response<Body, Fields>&& response) {
         bool keep_alive = response.keep_alive();
@@ -64,11 +70,15 @@ protected:
 
         auto self = GetSharedThis();
 
-        http::async_write(stream_, *safe_response,
-            [safe_response, self](beast::error_code ec, std::size_t bytes_written)
-            {
-                self->OnWrite(safe_response->need_eof(), ec, bytes_written);
-            });
+        // ответ может быть готов в strand приложения или в пуле рекордов:
+        // запись начинается в strand соединения, как и его чтение
+        net::dispatch(stream_.get_executor(), [safe_response, self] {
+            http::async_write(self->stream_, *safe_response,
+                [safe_response, self](beast::error_code ec, std::size_t bytes_written)
+                {
+                    self->OnWrite(safe_response->need_eof(), ec, bytes_written);
+                });
+        });
     }
 
 private:
@@ -90,17 +100,31 @@ private:
     virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
 };
 
-template <typename RequestHandler>
-class Session : public SessionBase, public std::enable_shared_from_this<Session<RequestHandler>> {
+// Обработчик WebSocket-запросов по умолчанию - соединение закрывается сразу после handshake.
+// Admit вызывается до handshake: непустой ответ отправляется вместо upgrade
+struct RejectWebSocket {
+    std::optional<http::response<http::string_body>> Admit([[maybe_unused]] const http::request<http::string_body>& request) const {
+        return std::nullopt;
+    }
+
+    void operator()(std::shared_ptr<WebSocketSession> session, [[maybe_unused]] const http::request<http::string_body>& request) const {
+        session->Close();
+    }
+};
+
+template <typename RequestHandler, typename WebSocketHandler>
+class Session : public SessionBase, public std::enable_shared_from_this<Session<RequestHandler, WebSocketHandler>> {
 public:
-    template<typename Handler>
-    Session(tcp::socket&& socket, Handler&& request_handler)
+    template<typename Handler, typename WsHandler>
+    Session(tcp::socket&& socket, Handler&& request_handler, WsHandler&& websocket_handler)
         : SessionBase(std::move(socket)),
-          request_handler_(std::forward<Handler>(request_handler)){
+          request_handler_(std::forward<Handler>(request_handler)),
+          websocket_handler_(std::forward<WsHandler>(websocket_handler)){
     }
 
 private:
     RequestHandler request_handler_;
+    WebSocketHandler websocket_handler_;
 
     std::shared_ptr<SessionBase> GetSharedThis() override {
         return this->shared_from_this();
@@ -115,20 +139,33 @@ private:
 
         logger::Info("request received"s, request_data);
 
+        if (websocket::is_upgrade(request)) {
+            // отказ в подключении (например, при перегрузке) уходит обычным http-ответом
+            if (auto rejection = websocket_handler_.Admit(request)) {
+                Write(std::move(*rejection));
+                return;
+            }
+
+            // дальше соединением владеет WebSocket-сессия, http-сессия завершается
+            std::make_shared<WebSocketSession>(ReleaseSocket())->Accept(std::move(request), websocket_handler_);
+            return;
+        }
+
         request_handler_(std::move(request), [self=this->shared_from_this()](auto&& response){
             self->Write(std::move(response));
         });
     }
 };
 
-template <typename RequestHandler>
-class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
+template <typename RequestHandler, typename WebSocketHandler>
+class Listener : public std::enable_shared_from_this<Listener<RequestHandler, WebSocketHandler>> {
 public:
-    template<typename Handler>
-    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler)
+    template<typename Handler, typename WsHandler>
+    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler, WsHandler&& websocket_handler)
         : ioc_(ioc),
           acceptor_(net::make_strand(ioc)),
-          request_handler_(std::forward<Handler>(request_handler)) {
+          request_handler_(std::forward<Handler>(request_handler)),
+          websocket_handler_(std::forward<WsHandler>(websocket_handler)) {
         acceptor_.open(endpoint.protocol());
 
         acceptor_.set_option(net::socket_base::reuse_address(true));
@@ -146,6 +183,7 @@ private:
     net::io_context& ioc_;
     tcp::acceptor acceptor_{net::make_strand(ioc_)};
     RequestHandler request_handler_;
+    WebSocketHandler websocket_handler_;
 
     void DoAccept() {
         acceptor_.async_accept(net::make_strand(ioc_), 
@@ -163,15 +201,20 @@ private:
     }
 
     void AsyncRunSession(tcp::socket&& socket){
-        std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_)->Run();
+        std::make_shared<Session<RequestHandler, WebSocketHandler>>(std::move(socket), request_handler_, websocket_handler_)->Run();
     }
 };
 
+template <typename RequestHandler, typename WebSocketHandler>
+void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler&& handler, WebSocketHandler&& websocket_handler) {
+    using MyListener = Listener<std::decay_t<RequestHandler>, std::decay_t<WebSocketHandler>>;
+
+    std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler), std::forward<WebSocketHandler>(websocket_handler))->Run();
+}
+
 template <typename RequestHandler>
 void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler&& handler) {
-    using MyListener = Listener<std::decay_t<RequestHandler>>;
-
-    std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler))->Run();
+    ServeHttp(ioc, endpoint, std::forward<RequestHandler>(handler), RejectWebSocket{});
 }
 
 }  // namespace http_server
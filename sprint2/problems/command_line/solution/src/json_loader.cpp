@@ -1,7 +1,7 @@
 #include "json_loader.h"
+#include "config_parser.h"
+#include "map_cache.h"
 #include <fstream>
-#include <sstream>
-#include <iostream>
 
 using namespace std::literals;
 
@@ -9,51 +9,28 @@ namespace json = boost::json;
 
 namespace json_loader {
 
-/// @brief Загрузить файл целиком
-/// @param filePath 
-/// @return 
-std::string LoadFile(const std::filesystem::path& filePath) {
-    std::ifstream ifs{filePath};
-
-    if (!ifs.is_open()) {
-        throw std::runtime_error("Не удалось открыть файл с конфигурацией");
-    }
-
-    std::ostringstream strbuf;
-
-    strbuf << ifs.rdbuf();
-
-    return strbuf.str();
-}
-
-std::vector<model::Map> LoadMaps(const json::value json_config)
-{
-    auto json_maps = json_config.as_object().at("maps"s);
-
-    auto maps = json::value_to<std::vector<model::Map>>(json_maps);
-
-    return maps;
-}
-
 model::Game LoadGame(const std::filesystem::path& json_path) {
-    // Загрузить содержимое файла json_path, например, в виде строки
-    // Распарсить строку как JSON, используя boost::json::parse
-    // Загрузить модель игры из файла
-    model::Game game;
+    // двоичный кэш читается за один проход; он действителен, пока не изменилось содержимое JSON.
+    // отпечаток считается блоками, поэтому файл целиком в памяти не держится
+    const auto fingerprint = map_cache::FingerprintFile(json_path);
+    const auto cache_path = map_cache::GetCachePath(json_path);
 
-    auto json_str = LoadFile(json_path);
+    auto cached = map_cache::LoadCachedGame(cache_path, fingerprint);
 
-    auto json_config = json::parse(json_str);
+    if (cached) {
+        return std::move(*cached);
+    }
 
-    auto maps = LoadMaps(json_config);
+    std::ifstream ifs {json_path, std::ios::binary};
 
-    for (auto&& map : maps) {
-        game.AddMap(std::move(map));
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Не удалось открыть файл с конфигурацией"s);
     }
 
-    if (json_config.as_object().if_contains("defaultDogSpeed"s) && json_config.at("defaultDogSpeed"s).is_double()){
-        game.SetDefaultDogSpeed(json_config.at("defaultDogSpeed"s).as_double());
-    }
+    auto game = ParseGame(ifs);
+
+    // без права записи рядом с конфигурацией сервер просто работает без кэша
+    map_cache::StoreCachedGame(cache_path, game, fingerprint);
 
     return game;
 }
@@ -61,27 +38,6 @@ model::Game LoadGame(const std::filesystem::path& json_path) {
 } // namespace json_loader
 
 namespace model {
-Road tag_invoke(json::value_to_tag<Road>, const json::value &jv) {
-    auto road_object = jv.as_object();
-
-    auto x0 = road_object.at("x0"s).to_number<int>();
-
-    auto y0 = road_object.at("y0"s).to_number<int>();
-
-    if (road_object.if_contains("x1"s)){
-        auto x1 = road_object.at("x1"s).to_number<int>();
-
-        return {Road::HORIZONTAL, Point{x0, y0}, x1};
-    }
-    else if (road_object.if_contains("y1"s)) {
-        auto y1 = road_object.at("y1"s).to_number<int>();
-
-        return {Road::VERTICAL, Point{x0, y0}, y1};
-    }
-
-    throw std::runtime_error("Неправильный формат описания дороги"s);
-}
-
 void tag_invoke(json::value_from_tag, json::value& jv, const Road& road){
     jv = {
         {"x0"s, road.GetStart().x},
@@ -90,15 +46,6 @@ void tag_invoke(json::value_from_tag, json::value& jv, const Road& road){
     };
 }
 
-Building tag_invoke(json::value_to_tag<Building>, const json::value& jv){
-    return model::Building{
-        model::Rectangle{
-            model::Point{jv.at("x"s).to_number<int>() ,jv.at("y"s).to_number<int>()}, 
-            model::Size{jv.at("w"s).to_number<int>(), jv.at("h"s).to_number<int>()}
-        }
-    };
-}
-
 void tag_invoke(json::value_from_tag, json::value &jv, const Building &building){
     jv = {
         {"x"s, building.GetBounds().position.x},
@@ -108,14 +55,6 @@ void tag_invoke(json::value_from_tag, json::value &jv, const Building &building)
     };
 }
 
-Office tag_invoke(json::value_to_tag<Office>, const json::value& jv){
-    return {
-        model::Office::Id(json::value_to<std::string>(jv.at("id"s))),
-        model::Point{jv.at("x"s).to_number<int>(), jv.at("y"s).to_number<int>()},
-        model::Offset{jv.at("offsetX"s).to_number<int>(), jv.at("offsetY"s).to_number<int>()}
-    };
-}
-
 void tag_invoke(json::value_from_tag, json::value &jv, const Office &office){
     jv = {
         {"id"s, *office.GetId()},
@@ -126,38 +65,6 @@ void tag_invoke(json::value_from_tag, json::value &jv, const Office &office){
     };
 }
 
-Map tag_invoke(json::value_to_tag<Map>, const json::value& jv){
-    auto id = Map::Id(json::value_to<std::string>(jv.at("id"s)));
-
-    auto name = json::value_to<std::string>(jv.at("name"s));
-
-    model::Map map{id, name};
-
-    auto roads = json::value_to<std::vector<Road>>(jv.at("roads"s));
-
-    for (const auto& road : roads) {
-        map.AddRoad(road);
-    }
-
-    auto buildings = json::value_to<std::vector<Building>>(jv.at("buildings"s));
-
-    for(const auto& building : buildings) {
-        map.AddBuilding(building);
-    }
-
-    auto offices = json::value_to<std::vector<Office>>(jv.at("offices"s));
-
-    for (auto&& office : offices){
-        map.AddOffice(std::move(office));
-    }
-
-    if (jv.as_object().if_contains("dogSpeed"s) && jv.at("dogSpeed"s).is_double()){
-        map.SetDogSpeed(jv.at("dogSpeed"s).as_double());
-    }
-
-    return map;
-}
-
 void tag_invoke(json::value_from_tag, json::value &jv, const Map* map){
     json::object obj = {
         {"id"s, *map->GetId()},
@@ -0,0 +1,377 @@
+#include "json_writer.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace json_writer {
+
+using namespace std::literals;
+
+void JsonWriter::String(std::string_view value) {
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    Separator();
+
+    _buffer.push_back('"');
+
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            _buffer.append("\\\""sv);
+            break;
+        case '\\':
+            _buffer.append("\\\\"sv);
+            break;
+        case '\b':
+            _buffer.append("\\b"sv);
+            break;
+        case '\f':
+            _buffer.append("\\f"sv);
+            break;
+        case '\n':
+            _buffer.append("\\n"sv);
+            break;
+        case '\r':
+            _buffer.append("\\r"sv);
+            break;
+        case '\t':
+            _buffer.append("\\t"sv);
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                _buffer.append("\\u00"sv);
+                _buffer.push_back(HEX[(c >> 4) & 0x0F]);
+                _buffer.push_back(HEX[c & 0x0F]);
+            } else {
+                _buffer.push_back(c);
+            }
+        }
+    }
+
+    _buffer.push_back('"');
+}
+
+void JsonWriter::Int(int64_t value) {
+    Separator();
+
+    char buffer[24];
+    auto [ptr, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+
+    _buffer.append(buffer, ptr);
+}
+
+void JsonWriter::UInt(uint64_t value) {
+    Separator();
+
+    char buffer[24];
+    auto [ptr, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+
+    _buffer.append(buffer, ptr);
+}
+
+void JsonWriter::Double(double value) {
+    Separator();
+
+    // так же, как boost::json::serialize
+    if (std::isnan(value)) {
+        _buffer.append("null"sv);
+        return;
+    }
+
+    if (std::isinf(value)) {
+        _buffer.append(value < 0 ? "-1e99999"sv : "1e99999"sv);
+        return;
+    }
+
+    // кратчайшее представление, как у ryu в boost::json: "1.5e+01" -> "1.5E1"
+    char buffer[32];
+    auto [ptr, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value, std::chars_format::scientific);
+
+    std::string_view formatted {buffer, static_cast<size_t>(ptr - buffer)};
+
+    auto exponentPos = formatted.find('e');
+
+    _buffer.append(formatted.substr(0, exponentPos));
+    _buffer.push_back('E');
+
+    auto exponent = formatted.substr(exponentPos + 1);
+
+    if (exponent.front() == '-') {
+        _buffer.push_back('-');
+    }
+
+    exponent.remove_prefix(1);
+
+    // ведущие нули порядка не пишутся, но сам порядок 0 - пишется
+    while (exponent.size() > 1 && exponent.front() == '0') {
+        exponent.remove_prefix(1);
+    }
+
+    _buffer.append(exponent);
+}
+
+void WriteMaps(std::string& out, const model::Game::Maps& maps) {
+    JsonWriter writer {out};
+
+    writer.BeginArray();
+
+    for (const auto& map : maps) {
+        writer.BeginObject();
+        writer.Key("id"sv);
+        writer.String(*map.GetId());
+        writer.Key("name"sv);
+        writer.String(map.GetName());
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+}
+
+void WriteMap(std::string& out, const model::Map& map) {
+    JsonWriter writer {out};
+
+    writer.BeginObject();
+
+    writer.Key("id"sv);
+    writer.String(*map.GetId());
+    writer.Key("name"sv);
+    writer.String(map.GetName());
+
+    writer.Key("roads"sv);
+    writer.BeginArray();
+
+    for (const auto& road : map.GetRoads()) {
+        writer.BeginObject();
+        writer.Key("x0"sv);
+        writer.Int(road.GetStart().x);
+        writer.Key("y0"sv);
+        writer.Int(road.GetStart().y);
+
+        if (road.IsHorizontal()) {
+            writer.Key("x1"sv);
+            writer.Int(road.GetEnd().x);
+        } else {
+            writer.Key("y1"sv);
+            writer.Int(road.GetEnd().y);
+        }
+
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+
+    writer.Key("buildings"sv);
+    writer.BeginArray();
+
+    for (const auto& building : map.GetBuildings()) {
+        const auto& bounds = building.GetBounds();
+
+        writer.BeginObject();
+        writer.Key("x"sv);
+        writer.Int(bounds.position.x);
+        writer.Key("y"sv);
+        writer.Int(bounds.position.y);
+        writer.Key("w"sv);
+        writer.Int(bounds.size.width);
+        writer.Key("h"sv);
+        writer.Int(bounds.size.height);
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+
+    writer.Key("offices"sv);
+    writer.BeginArray();
+
+    for (const auto& office : map.GetOffices()) {
+        writer.BeginObject();
+        writer.Key("id"sv);
+        writer.String(*office.GetId());
+        writer.Key("x"sv);
+        writer.Int(office.GetPosition().x);
+        writer.Key("y"sv);
+        writer.Int(office.GetPosition().y);
+        writer.Key("offsetX"sv);
+        writer.Int(office.GetOffset().dx);
+        writer.Key("offsetY"sv);
+        writer.Int(office.GetOffset().dy);
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+
+    writer.EndObject();
+}
+
+void WritePlayers(std::string& out, const std::vector<app::Player>& players) {
+    JsonWriter writer {out};
+
+    writer.BeginObject();
+
+    for (const auto& player : players) {
+        writer.Key(std::to_string(player.id));
+        writer.BeginObject();
+        writer.Key("name"sv);
+        writer.String(player.name);
+        writer.EndObject();
+    }
+
+    writer.EndObject();
+}
+
+void WriteAuthToken(std::string& out, const dto::AuthTokenDto& token) {
+    JsonWriter writer {out};
+
+    writer.BeginObject();
+    writer.Key("authToken"sv);
+    writer.String(token.AuthToken);
+    writer.Key("playerId"sv);
+    writer.UInt(token.PlayerId);
+    writer.EndObject();
+}
+
+/// @brief Гистограмма: верхние границы корзин, число значений в корзинах (последняя - выше всех границ), всего и сумма
+void WriteHistogram(JsonWriter& writer, const http_handler::Histogram& histogram) {
+    const auto bounds = histogram.GetBounds();
+
+    writer.BeginObject();
+    writer.Key("bounds"sv);
+    writer.BeginArray();
+    for (uint64_t bound : bounds) {
+        writer.UInt(bound);
+    }
+    writer.EndArray();
+    writer.Key("counts"sv);
+    writer.BeginArray();
+    for (size_t i = 0; i <= bounds.size(); ++i) {
+        writer.UInt(histogram.GetCount(i));
+    }
+    writer.EndArray();
+    writer.Key("count"sv);
+    writer.UInt(histogram.GetTotal());
+    writer.Key("sum"sv);
+    writer.UInt(histogram.GetSum());
+    writer.EndObject();
+}
+
+void WriteMetrics(std::string& out, const app::Metrics& metrics, const http_handler::RequestCounters& requests,
+    const http_handler::StrandMetrics& strand) {
+    JsonWriter writer {out};
+
+    writer.BeginObject();
+    writer.Key("dogs"sv);
+    writer.BeginObject();
+    writer.Key("active"sv);
+    writer.UInt(metrics.activeDogs);
+    writer.Key("idle"sv);
+    writer.UInt(metrics.idleDogs);
+    writer.EndObject();
+    writer.Key("requests"sv);
+    writer.BeginObject();
+    writer.Key("throttled"sv);
+    writer.UInt(requests.throttled);
+    writer.Key("shed"sv);
+    writer.UInt(requests.shed);
+    writer.Key("queueDepth"sv);
+    writer.UInt(requests.queueDepth);
+    writer.Key("queueWaitMs"sv);
+    writer.Double(requests.queueWaitMs);
+    writer.EndObject();
+    writer.Key("strand"sv);
+    writer.BeginObject();
+    writer.Key("queueDepth"sv);
+    WriteHistogram(writer, strand.GetDepthHistogram());
+    writer.Key("routes"sv);
+    writer.BeginObject();
+    for (size_t route = 0; route < http_handler::API_ROUTES.size(); ++route) {
+        const auto& routeMetrics = strand.GetRoute(route);
+
+        writer.Key(http_handler::API_ROUTES[route]);
+        writer.BeginObject();
+        writer.Key("waitUs"sv);
+        WriteHistogram(writer, routeMetrics.wait);
+        writer.Key("executionUs"sv);
+        WriteHistogram(writer, routeMetrics.execution);
+        writer.EndObject();
+    }
+    writer.EndObject();
+    writer.EndObject();
+    writer.EndObject();
+}
+
+std::string_view DirectionToString(model::Direction direction) {
+    switch (direction) {
+    case model::NORTH:
+        return "U"sv;
+    case model::SOUTH:
+        return "D"sv;
+    case model::EAST:
+        return "R"sv;
+    case model::WEST:
+        return "L"sv;
+    }
+
+    return ""sv;
+}
+
+void WriteDog(JsonWriter& writer, const model::Dog& dog) {
+    writer.Key(std::to_string(dog.playerId));
+    writer.BeginObject();
+
+    writer.Key("pos"sv);
+    writer.BeginArray();
+    writer.Double(dog.coord.x);
+    writer.Double(dog.coord.y);
+    writer.EndArray();
+
+    writer.Key("speed"sv);
+    writer.BeginArray();
+    writer.Double(dog.speed.vx);
+    writer.Double(dog.speed.vy);
+    writer.EndArray();
+
+    writer.Key("dir"sv);
+    writer.String(DirectionToString(dog.direction));
+
+    writer.EndObject();
+}
+
+void WriteGameState(std::string& out, model::GameSession& session) {
+    JsonWriter writer {out};
+
+    writer.BeginObject();
+    writer.Key("players"sv);
+    writer.BeginObject();
+
+    for (const auto& dog : session.GetDogs()) {
+        WriteDog(writer, dog);
+    }
+
+    writer.EndObject();
+    writer.EndObject();
+}
+
+void WriteVersionedGameState(std::string& out, model::GameSession& session, std::optional<uint64_t> since) {
+    const bool full = !since || !session.CanDeltaFrom(*since);
+
+    JsonWriter writer {out};
+
+    writer.BeginObject();
+    writer.Key("version"sv);
+    writer.UInt(session.GetVersion());
+    writer.Key("full"sv);
+    writer.Bool(full);
+    writer.Key("players"sv);
+    writer.BeginObject();
+
+    for (const auto& dog : session.GetDogs()) {
+        if (full || dog.version > *since) {
+            WriteDog(writer, dog);
+        }
+    }
+
+    writer.EndObject();
+    writer.EndObject();
+}
+
+}  // namespace json_writer
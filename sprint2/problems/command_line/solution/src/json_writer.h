@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "application.h"
+#include "dto.h"
+#include "model.h"
+#include "request_guard.h"
+#include "strand_metrics.h"
+
+namespace json_writer {
+
+/// @brief Потоковая запись JSON прямо в строку без построения json::value.
+/// Формат чисел и экранирование строк совпадают с boost::json::serialize.
+class JsonWriter {
+    std::string& _buffer;
+    // нужна ли запятая перед следующим элементом текущего массива/объекта
+    bool _needComma = false;
+
+    void Separator() {
+        if (_needComma) {
+            _buffer.push_back(',');
+        }
+
+        _needComma = true;
+    }
+
+    public:
+    explicit JsonWriter(std::string& buffer) : _buffer {buffer} {};
+
+    void BeginObject() {
+        Separator();
+        _buffer.push_back('{');
+        _needComma = false;
+    }
+
+    void EndObject() {
+        _buffer.push_back('}');
+        _needComma = true;
+    }
+
+    void BeginArray() {
+        Separator();
+        _buffer.push_back('[');
+        _needComma = false;
+    }
+
+    void EndArray() {
+        _buffer.push_back(']');
+        _needComma = true;
+    }
+
+    void Key(std::string_view key) {
+        String(key);
+        _buffer.push_back(':');
+        _needComma = false;
+    }
+
+    void String(std::string_view value);
+
+    void Int(int64_t value);
+
+    void UInt(uint64_t value);
+
+    void Double(double value);
+
+    void Bool(bool value) {
+        Separator();
+        _buffer.append(value ? "true" : "false");
+    }
+};
+
+void WriteMaps(std::string& out, const model::Game::Maps& maps);
+
+void WriteMap(std::string& out, const model::Map& map);
+
+void WritePlayers(std::string& out, const std::vector<app::Player>& players);
+
+void WriteAuthToken(std::string& out, const dto::AuthTokenDto& token);
+
+void WriteMetrics(std::string& out, const app::Metrics& metrics, const http_handler::RequestCounters& requests,
+    const http_handler::StrandMetrics& strand);
+
+void WriteGameState(std::string& out, model::GameSession& session);
+
+/// @brief Версия сессии и собаки, изменившиеся после версии since
+/// (полный снимок, если since не задана или дельту построить нельзя)
+void WriteVersionedGameState(std::string& out, model::GameSession& session, std::optional<uint64_t> since);
+
+}  // namespace json_writer
@@ -3,7 +3,9 @@
 
 #include <boost/asio/signal_set.hpp>
 #include <boost/asio/io_context.hpp>
+#include <cstdlib>
 #include <iostream>
+#include <random>
 #include <thread>
 
 #include "json_loader.h"
@@ -11,6 +13,9 @@
 #include "logger.h"
 #include "application.h"
 #include "ticker.h"
+#include "state_broadcaster.h"
+#include "records.h"
+#include "postgres.h"
 #include <boost/log/utility/manipulators/add_value.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/program_options.hpp>
@@ -29,6 +34,7 @@ struct Args {
     std::string config_file;
     std::string www_root;
     bool randomize_spawn_points;
+    std::optional<uint64_t> random_seed;
 
     Args() : tick_period{0}, config_file{}, www_root{}, randomize_spawn_points{false} {};
 };
@@ -45,7 +51,8 @@ struct Args {
         ("tick-period,t", po::value(&args.tick_period)->value_name("milliseconds"s), "set tick period")
         ("config-file,c", po::value(&args.config_file)->value_name("file"s)->required(), "set config file path")
         ("www-root,w", po::value(&args.www_root)->value_name("dir"s)->required(), "set static files root")
-        ("randomize-spawn-points", "spawn dogs at random positions");
+        ("randomize-spawn-points", "spawn dogs at random positions")
+        ("random-seed", po::value<uint64_t>()->value_name("seed"s), "seed the game random generators to replay a game");
 
     po::variables_map vm;
 
@@ -66,6 +73,10 @@ struct Args {
 
     args.randomize_spawn_points = vm.contains("randomize-spawn-points");
 
+    if (vm.contains("random-seed")) {
+        args.random_seed = vm["random-seed"].as<uint64_t>();
+    }
+
     return args;
 } 
 
@@ -82,6 +93,42 @@ void RunWorkers(unsigned workers_count, const Fn& fn) {
     fn();
 }
 
+// Зерно игры, запущенной без --random-seed
+uint64_t MakeRandomSeed() {
+    std::random_device device;
+
+    return (uint64_t{device()} << 32) | device();
+}
+
+using Strand = net::strand<net::io_context::executor_type>;
+
+// Перезагружает карты по SIGHUP. Конфигурация читается и графы дорог строятся
+// в потоке обработчика сигнала, в strand приложения выполняется только подмена карт
+void WaitReloadSignal(net::signal_set& signals, Strand strand, app::Application& application, const std::string& configFile) {
+    signals.async_wait([&signals, strand, &application, &configFile](const sys::error_code& ec, [[maybe_unused]] int signal_number) {
+        if (ec) {
+            return;
+        }
+
+        try {
+            auto game = std::make_shared<model::Game>(json_loader::LoadGame(configFile));
+
+            net::dispatch(strand, [&application, game] {
+                const auto maps = game->GetMaps().size();
+
+                application.ReplaceMaps(std::move(*game));
+
+                logger::Info("maps reloaded"s, {{"maps"s, maps}});
+            });
+        } catch (const std::exception& ex) {
+            // сервер продолжает работать на прежних картах
+            logger::Error("maps reload failed"s, {{"exception"s, ex.what()}});
+        }
+
+        WaitReloadSignal(signals, strand, application, configFile);
+    });
+}
+
 }  // namespace
 
 int main(int argc, const char* argv[]) {
@@ -94,6 +141,8 @@ int main(int argc, const char* argv[]) {
         // 1. Загружаем карту из файла и построить модель игры
         auto game = json_loader::LoadGame(args->config_file);
 
+        game.SetRandomSeed(args->random_seed ? *args->random_seed : MakeRandomSeed());
+
         app::Application application { game, args->randomize_spawn_points};
 
         // 2. Инициализируем io_context
@@ -112,23 +161,76 @@ int main(int argc, const char* argv[]) {
 
         auto apiStrand = net::make_strand(ioc);
 
+        // перезагрузка карт без остановки сервера: kill -HUP <pid>
+        net::signal_set reloadSignals(ioc, SIGHUP);
+
+        WaitReloadSignal(reloadSignals, apiStrand, application, args->config_file);
+
         auto timer = std::make_shared<app::ApplicationUpdateTimer>(apiStrand, application, std::chrono::milliseconds(args->tick_period));
 
         if (args->has_tick_period){
             timer->Start();
         }
 
+        // рекорды ушедших игроков пишутся в базу, если задан GAME_DB_URL;
+        // запись и чтение идут через разные соединения, чтобы запросы таблицы
+        // не ждали фоновую запись
+        std::unique_ptr<postgres::RecordsRepositoryImpl> recordsStore;
+        std::unique_ptr<postgres::RecordsRepositoryImpl> recordsReader;
+        std::unique_ptr<records::RecordsWriter> recordsWriter;
+        // запросы таблицы рекордов ждут базу здесь, а не в потоках io_context
+        std::optional<net::thread_pool> recordsPool;
+        std::optional<http_handler::RecordsBackend> recordsBackend;
+
+        if (const char* dbUrl = std::getenv("GAME_DB_URL")) {
+            recordsStore = std::make_unique<postgres::RecordsRepositoryImpl>(dbUrl);
+            recordsReader = std::make_unique<postgres::RecordsRepositoryImpl>(dbUrl);
+            // чтение идет через одно соединение, поэтому больше потоков пулу не нужно
+            recordsPool.emplace(1);
+            recordsBackend.emplace(http_handler::RecordsBackend {*recordsReader, recordsPool->get_executor()});
+            recordsWriter = std::make_unique<records::RecordsWriter>(*recordsStore, records::RecordsWriterConfig{}, [](const std::string& message){
+                logger::Error("records writer"s, {{"error"s, message}});
+            });
+
+            application.AddRetireHandler([writer = recordsWriter.get()](const std::vector<app::RetiredPlayer>& players){
+                std::vector<records::Record> batch;
+                batch.reserve(players.size());
+
+                for (const auto& retired : players) {
+                    batch.push_back({retired.player.name, retired.score, retired.playTime});
+                }
+
+                // только постановка в очередь: strand не ждет базу
+                writer->Push(std::move(batch));
+            });
+        }
+
         // 4. Создаём обработчик HTTP-запросов и связываем его с моделью игр
 
-        auto handler = std::make_shared<http_handler::RequestHandler>(http_handler::ApiHandler {application, args->has_tick_period}, http_handler::StaticFileRequestHandler(args->www_root), apiStrand);
+        // лимиты запросов и режим перегрузки перед очередью apiStrand
+        http_handler::RequestGuard guard;
+        http_handler::StrandMetrics strandMetrics;
+
+        auto handler = std::make_shared<http_handler::RequestHandler>(http_handler::ApiHandler {application, guard, strandMetrics, args->has_tick_period}, http_handler::StaticFileRequestHandler(args->www_root), apiStrand, guard, strandMetrics, recordsBackend);
 
         // 5. Запустить обработчик HTTP-запросов, делегируя их обработчику запросов
         const auto address = net::ip::make_address("0.0.0.0");
         constexpr net::ip::port_type port = 8080;
 
+        // рассылка состояния подписчикам WebSocket после каждого тика
+        auto broadcaster = std::make_shared<http_handler::StateBroadcaster>(application, apiStrand);
+
+        application.AddTickHandler([broadcaster]([[maybe_unused]] int64_t timeDelta){
+            broadcaster->Broadcast();
+        });
+
+        application.AddRetireHandler([broadcaster](const std::vector<app::RetiredPlayer>& players){
+            broadcaster->Unsubscribe(players);
+        });
+
         http_server::ServeHttp(ioc, {address, port}, [handler](auto&& request, auto&& writer){
             (*handler)(std::forward<decltype(request)>(request), std::forward<decltype(writer)>(writer));
-        });
+        }, http_handler::WebSocketHandler {broadcaster, guard});
         
         // инициализация логгера
         logger::InitBoostLogs();
@@ -146,6 +248,15 @@ int main(int argc, const char* argv[]) {
             ioc.run();
         });
 
+        if (recordsPool) {
+            recordsPool->join();
+        }
+
+        // дописать в базу накопленные рекорды
+        if (recordsWriter) {
+            recordsWriter->Stop();
+        }
+
         logger::Info("server exited"s, { {"code", 0 }});
     } catch (const std::exception& ex) {
         
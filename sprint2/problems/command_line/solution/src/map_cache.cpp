@@ -0,0 +1,191 @@
+#include "map_cache.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "binary_encoder.h"
+#include "road_graph.h"
+
+namespace map_cache {
+
+using namespace std::literals;
+
+// 'GSMC'
+constexpr uint32_t MAGIC = 0x434D5347;
+
+std::filesystem::path GetCachePath(const std::filesystem::path& configPath) {
+    auto cachePath = configPath;
+
+    cachePath += ".cache"sv;
+
+    return cachePath;
+}
+
+void ConfigFingerprint::Update(std::string_view chunk) noexcept {
+    for (char c : chunk) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+
+    size += chunk.size();
+}
+
+ConfigFingerprint FingerprintConfig(std::string_view config) noexcept {
+    ConfigFingerprint fingerprint;
+
+    fingerprint.Update(config);
+
+    return fingerprint;
+}
+
+ConfigFingerprint FingerprintFile(const std::filesystem::path& configPath) {
+    std::ifstream ifs {configPath, std::ios::binary};
+
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Не удалось открыть файл с конфигурацией"s);
+    }
+
+    ConfigFingerprint fingerprint;
+    std::string chunk(64 * 1024, '\0');
+
+    while (ifs.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || ifs.gcount() > 0) {
+        fingerprint.Update(std::string_view{chunk}.substr(0, static_cast<size_t>(ifs.gcount())));
+    }
+
+    return fingerprint;
+}
+
+void EncodeGame(std::string& out, const model::Game& game, const ConfigFingerprint& config) {
+    binary::Writer writer {out};
+
+    writer.U32(MAGIC);
+    writer.U32(FORMAT_VERSION);
+    writer.U64(config.size);
+    writer.U64(config.hash);
+
+    writer.F64(game.GetDefaultDogSpeed());
+    writer.U64(game.GetDefaultSessionCapacity());
+
+    const auto retirementTime = game.GetDogRetirementTime();
+
+    writer.U8(retirementTime ? 1 : 0);
+    writer.U64(static_cast<uint64_t>(retirementTime.value_or(0)));
+
+    writer.U32(static_cast<uint32_t>(game.GetMaps().size()));
+
+    for (const auto& map : game.GetMaps()) {
+        binary::EncodeMap(out, map);
+
+        writer.U8(map.GetDogSpeed() ? 1 : 0);
+        writer.F64(map.GetDogSpeed().value_or(0));
+        writer.U8(map.GetSessionCapacity() ? 1 : 0);
+        writer.U64(map.GetSessionCapacity().value_or(0));
+    }
+}
+
+std::optional<model::Game> DecodeGame(std::string_view data, const ConfigFingerprint& config) {
+    binary::Reader reader {data};
+
+    try {
+        if (reader.U32() != MAGIC || reader.U32() != FORMAT_VERSION
+            || reader.U64() != config.size || reader.U64() != config.hash) {
+            return std::nullopt;
+        }
+
+        model::Game game;
+
+        game.SetDefaultDogSpeed(reader.F64());
+        game.SetDefaultSessionCapacity(reader.U64());
+
+        const bool hasRetirementTime = reader.U8() != 0;
+        const auto retirementTime = static_cast<int64_t>(reader.U64());
+
+        if (hasRetirementTime) {
+            game.SetDogRetirementTime(retirementTime);
+        }
+
+        for (uint32_t count = reader.U32(); count > 0; --count) {
+            auto map = binary::DecodeMap(reader);
+
+            const bool hasDogSpeed = reader.U8() != 0;
+            const double dogSpeed = reader.F64();
+
+            if (hasDogSpeed) {
+                map.SetDogSpeed(dogSpeed);
+            }
+
+            const bool hasSessionCapacity = reader.U8() != 0;
+            const uint64_t sessionCapacity = reader.U64();
+
+            if (hasSessionCapacity) {
+                map.SetSessionCapacity(sessionCapacity);
+            }
+
+            map.SetRoadGraph(std::make_shared<const model::RoadGraph>(map.GetRoads()));
+
+            game.AddMap(std::move(map));
+        }
+
+        if (!reader.AtEnd()) {
+            return std::nullopt;
+        }
+
+        return game;
+    } catch (const std::exception&) {
+        // обрезанный или испорченный кэш - читаем JSON
+        return std::nullopt;
+    }
+}
+
+std::optional<model::Game> LoadCachedGame(const std::filesystem::path& cachePath, const ConfigFingerprint& config) {
+    std::ifstream ifs {cachePath, std::ios::binary};
+
+    if (!ifs.is_open()) {
+        return std::nullopt;
+    }
+
+    std::ostringstream strbuf;
+
+    strbuf << ifs.rdbuf();
+
+    return DecodeGame(strbuf.view(), config);
+}
+
+bool StoreCachedGame(const std::filesystem::path& cachePath, const model::Game& game, const ConfigFingerprint& config) {
+    std::string data;
+
+    EncodeGame(data, game, config);
+
+    auto tmpPath = cachePath;
+
+    tmpPath += ".tmp"sv;
+
+    std::error_code ec;
+
+    {
+        std::ofstream ofs {tmpPath, std::ios::binary | std::ios::trunc};
+
+        if (!ofs.is_open()) {
+            return false;
+        }
+
+        if (!ofs.write(data.data(), static_cast<std::streamsize>(data.size())) || !ofs.flush()) {
+            ofs.close();
+            std::filesystem::remove(tmpPath, ec);
+
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, cachePath, ec);
+
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace map_cache
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "model.h"
+
+/*
+ * Двоичный кэш конфигурации игры. Создается рядом с JSON-файлом при первой загрузке
+ * и читается за один проход вместо разбора JSON, пока содержимое JSON не изменилось.
+ * Формат (числа little-endian, как в binary::Writer):
+ *   uint32 magic 'GSMC', uint32 FORMAT_VERSION,
+ *   uint64 размер JSON, uint64 хеш JSON (FNV-1a),
+ *   float64 defaultDogSpeed, uint64 defaultSessionCapacity,
+ *   uint8 есть dogRetirementTime, uint64 dogRetirementTime (мс),
+ *   uint32 maps * { карта binary::EncodeMap,
+ *                   uint8 есть dogSpeed, float64 dogSpeed,
+ *                   uint8 есть sessionCapacity, uint64 sessionCapacity }
+ * Граф дорог в кэш не входит и строится при чтении, как и при разборе JSON.
+ */
+namespace map_cache {
+
+inline constexpr uint32_t FORMAT_VERSION = 2;
+
+/// @brief Путь к кэшу для файла конфигурации
+std::filesystem::path GetCachePath(const std::filesystem::path& configPath);
+
+/// @brief Размер и хеш содержимого JSON (FNV-1a, 64 бита).
+/// Считается по частям, поэтому файл не нужно держать в памяти целиком
+struct ConfigFingerprint {
+    uint64_t size = 0;
+    uint64_t hash = 14695981039346656037ull;
+
+    void Update(std::string_view chunk) noexcept;
+
+    bool operator==(const ConfigFingerprint&) const = default;
+};
+
+ConfigFingerprint FingerprintConfig(std::string_view config) noexcept;
+
+/// @brief Отпечаток файла конфигурации, читаемого блоками
+ConfigFingerprint FingerprintFile(const std::filesystem::path& configPath);
+
+/// @brief Записать игру, загруженную из JSON с отпечатком config, в формате кэша
+void EncodeGame(std::string& out, const model::Game& game, const ConfigFingerprint& config);
+
+/// @brief Игра из кэша data с построенными графами дорог. nullopt, если кэш поврежден, другой версии или построен по другому JSON
+std::optional<model::Game> DecodeGame(std::string_view data, const ConfigFingerprint& config);
+
+/// @brief Загрузить игру из файла кэша, если он соответствует config
+std::optional<model::Game> LoadCachedGame(const std::filesystem::path& cachePath, const ConfigFingerprint& config);
+
+/// @brief Сохранить кэш: запись во временный файл и переименование, чтобы параллельный
+/// запуск не прочитал недописанный кэш. false, если записать не удалось
+bool StoreCachedGame(const std::filesystem::path& cachePath, const model::Game& game, const ConfigFingerprint& config);
+
+}  // namespace map_cache
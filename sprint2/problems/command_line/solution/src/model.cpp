@@ -27,29 +27,108 @@ void Map::AddOffice(Office&& office) {
 }
 
 void Game::AddMap(Map&& map) {
-    const size_t index = maps_.size();
-    if (auto [it, inserted] = map_id_to_index_.emplace(map.GetId(), index); !inserted) {
+    // на карты уже ссылаются сессии - вставка не должна перемещать их карты
+    if (_maps.use_count() > 1) {
+        _maps = std::make_shared<MapRegistry>(*_maps);
+    }
+
+    auto& maps = _maps->maps;
+    auto& index = _maps->index;
+
+    if (auto [it, inserted] = index.emplace(map.GetId(), maps.size()); !inserted) {
         throw std::invalid_argument("Map with id "s + *map.GetId() + " already exists"s);
     } else {
         try {
-            maps_.emplace_back(std::move(map));
+            maps.emplace_back(std::move(map));
         } catch (...) {
-            map_id_to_index_.erase(it);
+            index.erase(it);
             throw;
         }
     }
 }
 
+void Game::ReplaceMaps(Game&& loaded) {
+    _maps = std::move(loaded._maps);
+    loaded._maps = std::make_shared<MapRegistry>();
+
+    _defaultDogSpeed = loaded._defaultDogSpeed;
+    _defaultSessionCapacity = loaded._defaultSessionCapacity;
+}
+
 GameSession* Game::FindSessionByMapId(const Map::Id& mapId){
-    auto session = rs::find_if(_sessions, [mapId](auto arg){return arg.GetMapId() == mapId;});
+    auto sessions = _mapSessions.find(mapId);
 
-    return session == _sessions.end() ? nullptr : &(*session);
+    return sessions == _mapSessions.end() ? nullptr : _sessions.Find(sessions->second.front());
 }
 
 GameSession& Game::CreateSession(const Map::Id& mapId){
-    int sessionId = _sessions.size() + 1;
+    auto it = _maps->index.find(mapId);
+
+    if (it == _maps->index.end()){
+        throw std::invalid_argument("Map with id "s + *mapId + " not found"s);
+    }
+
+    const SessionId sessionId = _sessions.PeekNextId();
+
+    _mapSessions[mapId].push_back(sessionId);
+
+    // зерно сессии зависит от общего зерна и номера сессии
+    uint64_t seed = _randomSeed ^ sessionId;
+
+    // указатель на карту разделяет владение набором карт
+    return _sessions.Emplace(GameSession{sessionId, std::shared_ptr<const Map>{_maps, &_maps->maps[it->second]},
+                                         util::FastRandom::SplitMix64(seed)});
+}
+
+bool Game::RemoveSession(SessionId sessionId){
+    auto session = _sessions.Find(sessionId);
+
+    if (!session){
+        return false;
+    }
+
+    auto sessions = _mapSessions.find(session->GetMapId());
+    auto& ids = sessions->second;
+
+    // порядок сессий карты не важен - удаляем перестановкой с последней
+    *rs::find(ids, sessionId) = ids.back();
+    ids.pop_back();
+
+    if (ids.empty()){
+        _mapSessions.erase(sessions);
+    }
+
+    return _sessions.Erase(sessionId);
+}
+
+GameSession& Game::PlaceNewPlayer(const Map::Id& mapId){
+    const auto* map = FindMap(mapId);
+
+    if (!map){
+        throw std::invalid_argument("Map with id "s + *mapId + " not found"s);
+    }
+
+    const size_t capacity = GetSessionCapacity(*map);
+
+    GameSession* result = nullptr;
+
+    if (auto sessions = _mapSessions.find(mapId); sessions != _mapSessions.end()){
+        for (SessionId sessionId : sessions->second){
+            auto& session = *_sessions.Find(sessionId);
+            const size_t players = session.GetDogs().size();
+
+            // сессии, созданные до перезагрузки карт, новых игроков не принимают
+            if (&session.GetMap() != map){
+                continue;
+            }
+
+            if (players < capacity && (!result || players < result->GetDogs().size())){
+                result = &session;
+            }
+        }
+    }
 
-    return _sessions.emplace_back(GameSession{sessionId, mapId});
+    return result ? *result : CreateSession(mapId);
 }
 
 }  // namespace model
@@ -5,7 +5,12 @@
 #include <optional>
 #include <ranges>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
 
+#include "fast_random.h"
+#include "slot_map.h"
 #include "tagged.h"
 
 namespace rs = std::ranges;
@@ -47,20 +52,23 @@ public:
 
     Road(HorizontalTag, Point start, Coord end_x) noexcept
         : start_{start}
-        , end_{end_x, start.y} {
+        , end_{end_x, start.y}
+        , horizontal_{true} {
     }
 
     Road(VerticalTag, Point start, Coord end_y) noexcept
         : start_{start}
-        , end_{start.x, end_y} {
+        , end_{start.x, end_y}
+        , horizontal_{false} {
     }
 
+    // направление задается при создании: у дороги нулевой длины его не определить по концам
     bool IsHorizontal() const noexcept {
-        return start_.y == end_.y;
+        return horizontal_;
     }
 
     bool IsVertical() const noexcept {
-        return start_.x == end_.x;
+        return !horizontal_;
     }
 
     Point GetStart() const noexcept {
@@ -74,6 +82,7 @@ public:
 private:
     Point start_;
     Point end_;
+    bool horizontal_;
 };
 
 class Building {
@@ -118,6 +127,8 @@ private:
     Offset offset_;
 };
 
+class RoadGraph;
+
 class Map {
 public:
     using Id = util::Tagged<std::string, Map>;
@@ -154,6 +165,10 @@ public:
         return _dogSpeed;
     }
 
+    std::optional<size_t> GetSessionCapacity() const noexcept {
+        return _sessionCapacity;
+    }
+
     void AddRoad(const Road& road) {
         roads_.emplace_back(road);
     }
@@ -168,6 +183,19 @@ public:
         _dogSpeed.emplace(speed);
     }
 
+    void SetSessionCapacity(size_t capacity) {
+        _sessionCapacity.emplace(capacity);
+    }
+
+    /// @brief Граф дорог, построенный при загрузке карты
+    const RoadGraph& GetRoadGraph() const noexcept {
+        return *_roadGraph;
+    }
+
+    void SetRoadGraph(std::shared_ptr<const RoadGraph> graph) {
+        _roadGraph = std::move(graph);
+    }
+
 private:
     using OfficeIdToIndex = std::unordered_map<Office::Id, size_t, util::TaggedHasher<Office::Id>>;
 
@@ -176,6 +204,8 @@ private:
     Roads roads_;
     Buildings buildings_;
     std::optional<double> _dogSpeed;
+    std::optional<size_t> _sessionCapacity;
+    std::shared_ptr<const RoadGraph> _roadGraph;
 
     OfficeIdToIndex warehouse_id_to_index_;
     Offices offices_;
@@ -198,50 +228,150 @@ struct Speed {
     double vy;
 };
 
+// идентификаторы выдаются контейнерами SlotMap и остаются верными, пока объект существует
+using DogId = util::SlotId;
+using PlayerId = util::SlotId;
+using SessionId = util::SlotId;
+
 struct Dog {
     std::string name;
-    int id;
-    int playerId;
+    DogId id;
+    PlayerId playerId;
     Position coord;
     Speed speed;
     Direction direction;
+    // версия сессии, в которой собака последний раз изменилась
+    uint64_t version = 0;
+    // индекс дороги в графе дорог карты, на которой стоит собака
+    size_t road = 0;
+    // позиция в списке движущихся собак сессии
+    size_t activePosition = std::numeric_limits<size_t>::max();
+    // набранные очки; попадают в таблицу рекордов при уходе игрока
+    uint64_t score = 0;
 
     public:
-    Dog(int id, int playerId, Position initCoord) : id { id }, playerId { playerId }, direction{NORTH}, speed{}, coord{initCoord} {};
+    Dog(DogId id, PlayerId playerId, Position initCoord, size_t road) : id { id }, playerId { playerId }, direction{NORTH}, speed{}, coord{initCoord}, road{road} {};
 };
 
 class GameSession {
-    int _id;
-    Map::Id _mapId;
-    std::vector<Dog> _dogs;
+    SessionId _id;
+    // карта, с которой создана сессия; после перезагрузки карт сессия держит старую карту до своего удаления
+    std::shared_ptr<const Map> _map;
+    util::SlotMap<Dog> _dogs;
+    // счетчик изменений сессии
+    uint64_t _version = 0;
+    // версия последнего удаления собаки: дельту от более ранних версий построить нельзя
+    uint64_t _removedVersion = 0;
+    // движущиеся собаки
+    std::vector<DogId> _activeDogs;
+    // случайные числа сессии: точки появления собак
+    util::FastRandom _random;
+
+    static constexpr size_t NOT_ACTIVE = std::numeric_limits<size_t>::max();
+
+    void UpdateActivity(Dog& dog) noexcept {
+        const bool moving = dog.speed.vx != 0 || dog.speed.vy != 0;
+
+        if (moving && dog.activePosition == NOT_ACTIVE){
+            dog.activePosition = _activeDogs.size();
+            _activeDogs.push_back(dog.id);
+        }
+        else if (!moving && dog.activePosition != NOT_ACTIVE){
+            // на место удаляемой ставим последнюю собаку списка
+            const DogId last = _activeDogs.back();
+
+            _activeDogs[dog.activePosition] = last;
+            _dogs.Find(last)->activePosition = dog.activePosition;
+            _activeDogs.pop_back();
+            dog.activePosition = NOT_ACTIVE;
+        }
+    }
 
     public:
-    explicit GameSession(int id, const Map::Id& mapId) : _id {id}, _mapId {mapId} {};
+    explicit GameSession(SessionId id, std::shared_ptr<const Map> map, uint64_t randomSeed = 0)
+        : _id {id}, _map {std::move(map)}, _random {randomSeed} {};
 
-    const Map::Id& GetMapId() {
-        return _mapId;
+    const Map::Id& GetMapId() const noexcept {
+        return _map->GetId();
     }
 
-    int GetId() {
+    const Map& GetMap() const noexcept {
+        return *_map;
+    }
+
+    SessionId GetId() const noexcept {
         return _id;
     }
 
-    void AddDog(int playerId, const Position& coord) {
-        int dogId = _dogs.size() + 1;
+    util::FastRandom& GetRandom() noexcept {
+        return _random;
+    }
+
+    Dog& AddDog(PlayerId playerId, const Position& coord, size_t road) {
+        auto& dog = _dogs.Emplace(Dog{_dogs.PeekNextId(), playerId, coord, road});
+
+        MarkChanged(dog);
+
+        return dog;
+    }
+
+    /// @brief Удалить собаку за O(1). Идентификатор удаленной собаки больше ничего не находит.
+    bool RemoveDog(DogId dogId) {
+        auto dog = _dogs.Find(dogId);
+
+        if (!dog){
+            return false;
+        }
+
+        dog->speed = {};
+        UpdateActivity(*dog);
+
+        _removedVersion = ++_version;
+
+        return _dogs.Erase(dogId);
+    }
+
+    uint64_t GetVersion() const noexcept {
+        return _version;
+    }
 
-        _dogs.emplace_back(Dog{dogId, playerId, coord});
+    /// @brief Отметить изменение положения, скорости или направления собаки.
+    /// Заодно обновляет множество движущихся собак.
+    void MarkChanged(Dog& dog) noexcept {
+        dog.version = ++_version;
+
+        UpdateActivity(dog);
     }
 
-    std::vector<Dog>& GetDogs(){
+    /// @brief Вызвать action для каждой движущейся собаки.
+    /// Собака может остановиться внутри action (через MarkChanged) - обход идет с конца,
+    /// поэтому удаление текущей собаки из списка не ломает его.
+    template <typename Action>
+    void ForEachActiveDog(Action&& action) {
+        for (size_t i = _activeDogs.size(); i-- > 0;){
+            action(*_dogs.Find(_activeDogs[i]));
+        }
+    }
+
+    size_t GetActiveDogCount() const noexcept {
+        return _activeDogs.size();
+    }
+
+    /// @brief Можно ли передать клиенту только изменения после версии since
+    bool CanDeltaFrom(uint64_t since) const noexcept {
+        return since >= _removedVersion && since <= _version;
+    }
+
+    util::SlotMap<Dog>& GetDogs(){
         return _dogs;
     }
 
-    Dog* GetDogByPlayerId(int playerId) {
-        auto dog = rs::find_if(_dogs, [playerId](auto arg){return arg.playerId == playerId;});
+    const util::SlotMap<Dog>& GetDogs() const {
+        return _dogs;
+    }
 
-        return dog == _dogs.end()
-            ?  nullptr
-            : &(*dog);
+    Dog* GetDog(DogId dogId) {
+        return _dogs.Find(dogId);
     }
 };
 
@@ -251,42 +381,84 @@ public:
 
     void AddMap(Map&& map);
 
+    /// @brief Заменить карты и настройки по умолчанию загруженными из новой конфигурации.
+    /// Новые игроки попадают в сессии новых карт, существующие сессии доигрывают
+    /// на своих картах: старые карты живут, пока на них ссылается хоть одна сессия.
+    /// dogRetirementTime не перезагружается: таймеры ухода игроков заводятся при входе
+    /// с прежним значением, поэтому новое применяется только после перезапуска сервера.
+    void ReplaceMaps(Game&& loaded);
+
     const Maps& GetMaps() const noexcept {
-        return maps_;
+        return _maps->maps;
     }
 
     const Map* FindMap(const Map::Id& id) const noexcept {
-        if (auto it = map_id_to_index_.find(id); it != map_id_to_index_.end()) {
-            return &maps_.at(it->second);
+        if (auto it = _maps->index.find(id); it != _maps->index.end()) {
+            return &_maps->maps.at(it->second);
         }
         return nullptr;
     }
 
-    GameSession* GetSession(int sessionId){
-        auto result = rs::find_if(_sessions, [sessionId](auto arg){return arg.GetId() == sessionId;});
-
-        return result == _sessions.end() ? nullptr : &(*result);
+    GameSession* GetSession(SessionId sessionId){
+        return _sessions.Find(sessionId);
     }
 
-    std::vector<GameSession>& GetSessions() {
+    util::SlotMap<GameSession>& GetSessions() {
         return _sessions;
     }
 
     GameSession* FindSessionByMapId(const Map::Id& mapId);
     GameSession& CreateSession(const Map::Id& mapId);
 
+    /// @brief Удалить сессию за O(1). Идентификатор удаленной сессии больше ничего не находит.
+    bool RemoveSession(SessionId sessionId);
+
+    /// @brief Сессия для нового игрока карты: наименее заполненная из неполных.
+    /// Если все сессии карты заполнены или их еще нет, создается новая.
+    GameSession& PlaceNewPlayer(const Map::Id& mapId);
+
+    /// @brief Максимальное число игроков в одной сессии карты
+    size_t GetSessionCapacity(const Map& map) const noexcept {
+        return map.GetSessionCapacity().value_or(_defaultSessionCapacity);
+    }
+
     void SetDefaultDogSpeed(double speed) { _defaultDogSpeed = speed; }
-    int GetDefaultDogSpeed() const {return _defaultDogSpeed; }
+    double GetDefaultDogSpeed() const {return _defaultDogSpeed; }
+
+    void SetDefaultSessionCapacity(size_t capacity) { _defaultSessionCapacity = capacity; }
+    size_t GetDefaultSessionCapacity() const noexcept { return _defaultSessionCapacity; }
+
+    /// @brief Время бездействия в миллисекундах, после которого игрок уходит из игры
+    std::optional<int64_t> GetDogRetirementTime() const noexcept { return _dogRetirementTime; }
+    void SetDogRetirementTime(int64_t milliseconds) { _dogRetirementTime = milliseconds; }
+
+    /// @brief Зерно, из которого получаются зерна генераторов сессий:
+    /// с одним зерном игра воспроизводится
+    uint64_t GetRandomSeed() const noexcept { return _randomSeed; }
+    void SetRandomSeed(uint64_t seed) noexcept { _randomSeed = seed; }
 
 private:
     using MapIdHasher = util::TaggedHasher<Map::Id>;
     using MapIdToIndex = std::unordered_map<Map::Id, size_t, MapIdHasher>;
 
-    std::vector<Map> maps_;
-    MapIdToIndex map_id_to_index_;
+    /// @brief Набор карт одной конфигурации. Сессии ссылаются на свои карты
+    /// через указатели, разделяющие владение всем набором
+    struct MapRegistry {
+        Maps maps;
+        MapIdToIndex index;
+    };
+
+    std::shared_ptr<MapRegistry> _maps = std::make_shared<MapRegistry>();
 
-    std::vector<GameSession> _sessions;
+    util::SlotMap<GameSession> _sessions;
+    // сессии каждой карты
+    std::unordered_map<Map::Id, std::vector<SessionId>, MapIdHasher> _mapSessions;
     double _defaultDogSpeed = 1;
+    // по умолчанию размер сессии не ограничен
+    size_t _defaultSessionCapacity = std::numeric_limits<size_t>::max();
+    // без настройки игроки не уходят по бездействию
+    std::optional<int64_t> _dogRetirementTime;
+    uint64_t _randomSeed = 0;
 };
 
 }  // namespace model
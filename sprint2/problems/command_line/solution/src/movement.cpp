@@ -0,0 +1,71 @@
+#include "movement.h"
+
+namespace app {
+
+    void MoveDog(model::Dog& dog, const model::RoadGraph& graph, double seconds){
+        if (dog.speed.vx == 0 && dog.speed.vy == 0){
+            return;
+        }
+
+        const bool alongX = dog.speed.vx != 0;
+        const bool forward = alongX ? dog.speed.vx > 0 : dog.speed.vy > 0;
+
+        // координата вдоль оси движения и поперек нее
+        double& along = alongX ? dog.coord.x : dog.coord.y;
+        double& velocity = alongX ? dog.speed.vx : dog.speed.vy;
+        const double across = alongX ? dog.coord.y : dog.coord.x;
+        const double target = along + velocity * seconds;
+
+        // границы прямоугольника дороги вдоль и поперек оси движения
+        auto alongMin = [alongX](const model::RoadBounds& b){ return alongX ? b.x_min : b.y_min; };
+        auto alongMax = [alongX](const model::RoadBounds& b){ return alongX ? b.x_max : b.y_max; };
+        auto acrossMin = [alongX](const model::RoadBounds& b){ return alongX ? b.y_min : b.x_min; };
+        auto acrossMax = [alongX](const model::RoadBounds& b){ return alongX ? b.y_max : b.x_max; };
+        auto end = [&](const model::RoadBounds& b){ return forward ? alongMax(b) : alongMin(b); };
+        auto reached = [forward, target](double bound){ return forward ? target <= bound : target >= bound; };
+
+        const auto& roads = graph.GetRoads();
+
+        size_t current = dog.road;
+        double bound = end(roads[current].bounds);
+
+        // событие - переход на соседнюю дорогу, которая продолжает путь за границу текущей
+        while (!reached(bound)){
+            size_t next = current;
+            double nextBound = bound;
+
+            for (const auto& link : roads[current].links){
+                const auto& bounds = roads[link.road].bounds;
+
+                if (across < acrossMin(bounds) || across > acrossMax(bounds)
+                    || bound < alongMin(bounds) || bound > alongMax(bounds)){
+                    continue;
+                }
+
+                const double candidate = end(bounds);
+
+                if (forward ? candidate > nextBound : candidate < nextBound){
+                    next = link.road;
+                    nextBound = candidate;
+                }
+            }
+
+            if (next == current){
+                break;
+            }
+
+            current = next;
+            bound = nextBound;
+        }
+
+        dog.road = current;
+
+        if (reached(bound)){
+            along = target;
+            return;
+        }
+
+        along = bound;
+        velocity = 0;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "model.h"
+#include "road_graph.h"
+
+namespace app {
+
+    /// @brief Переместить собаку за seconds секунд по графу дорог карты.
+    /// Собака переходит с дороги на соседнюю через общие узлы, сколько бы ни длился тик;
+    /// упершись в край дороги, останавливается в точке края. Стоящая собака не обрабатывается.
+    void MoveDog(model::Dog& dog, const model::RoadGraph& graph, double seconds);
+}
@@ -0,0 +1,101 @@
+#include "postgres.h"
+
+#include <pqxx/except>
+#include <pqxx/stream_to>
+#include <pqxx/transaction>
+#include <pqxx/zview.hxx>
+
+namespace postgres {
+
+using namespace std::literals;
+using pqxx::operator"" _zv;
+
+template <typename Fn>
+auto RecordsRepositoryImpl::WithConnection(Fn&& fn) {
+    std::lock_guard lock {_mutex};
+
+    try {
+        return fn(GetConnection());
+    } catch (const pqxx::broken_connection&) {
+        _connection.reset();
+        throw;
+    }
+}
+
+pqxx::connection& RecordsRepositoryImpl::GetConnection() {
+    if (_connection && !_connection->is_open()) {
+        _connection.reset();
+    }
+
+    if (!_connection) {
+        _connection.emplace(_dbUrl);
+    }
+
+    return *_connection;
+}
+
+RecordsRepositoryImpl::RecordsRepositoryImpl(const std::string& dbUrl)
+    : _dbUrl {dbUrl}, _connection {std::in_place, dbUrl} {
+    pqxx::work work {*_connection};
+
+    // длина name совпадает с records::MAX_NAME_LENGTH, которую проверяет вход в игру
+    work.exec(R"(
+CREATE TABLE IF NOT EXISTS retired_players (
+    id SERIAL PRIMARY KEY,
+    name varchar(100) NOT NULL,
+    score bigint NOT NULL,
+    play_time_ms bigint NOT NULL
+);
+)"_zv);
+
+    // индекс в порядке выдачи: LIMIT/OFFSET читает начало индекса без сортировки
+    work.exec(R"(
+CREATE INDEX IF NOT EXISTS retired_players_score_idx
+    ON retired_players (score DESC, play_time_ms, name);
+)"_zv);
+
+    work.commit();
+}
+
+void RecordsRepositoryImpl::Save(const std::vector<records::Record>& records) {
+    if (records.empty()) {
+        return;
+    }
+
+    WithConnection([&records](pqxx::connection& connection) {
+        pqxx::work work {connection};
+
+        auto stream = pqxx::stream_to::table(work, {"retired_players"_zv}, {"name"_zv, "score"_zv, "play_time_ms"_zv});
+
+        for (const auto& record : records) {
+            stream.write_values(record.name, static_cast<int64_t>(record.score), record.playTime);
+        }
+
+        stream.complete();
+        work.commit();
+    });
+}
+
+std::vector<records::Record> RecordsRepositoryImpl::Load(size_t start, size_t maxItems) {
+    return WithConnection([start, maxItems](pqxx::connection& connection) {
+        pqxx::read_transaction transaction {connection};
+
+        std::vector<records::Record> result;
+
+        result.reserve(maxItems);
+
+        const auto rows = transaction.exec_params(R"(
+SELECT name, score, play_time_ms FROM retired_players
+ORDER BY score DESC, play_time_ms, name
+LIMIT $1 OFFSET $2;
+)"_zv, static_cast<int64_t>(maxItems), static_cast<int64_t>(start));
+
+        for (const auto& row : rows) {
+            result.push_back({row[0].as<std::string>(), static_cast<uint64_t>(row[1].as<int64_t>()), row[2].as<int64_t>()});
+        }
+
+        return result;
+    });
+}
+
+}  // namespace postgres
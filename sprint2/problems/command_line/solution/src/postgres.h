@@ -0,0 +1,40 @@
+#pragma once
+#include <mutex>
+#include <optional>
+#include <string>
+#include <pqxx/connection>
+
+#include "records.h"
+
+namespace postgres {
+
+    /// @brief Результаты ушедших игроков в таблице retired_players.
+    /// Соединение pqxx не потокобезопасно, поэтому обращения к нему идут под мьютексом;
+    /// фоновой записи и запросам HTTP лучше дать по отдельному экземпляру.
+    class RecordsRepositoryImpl : public records::RecordsRepository {
+    public:
+        /// @brief Подключается к базе и создает таблицу и индекс, если их еще нет.
+        /// После обрыва соединения (например, перезапуска базы) подключается заново
+        explicit RecordsRepositoryImpl(const std::string& dbUrl);
+
+        /// @brief Пачка пишется одной транзакцией через COPY
+        void Save(const std::vector<records::Record>& records) override;
+
+        /// @brief Чтение по индексу (score DESC, play_time_ms, name)
+        std::vector<records::Record> Load(size_t start, size_t maxItems) override;
+
+    private:
+        std::string _dbUrl;
+        std::mutex _mutex;
+        // пусто - соединение оборвалось и будет открыто заново при следующем обращении
+        std::optional<pqxx::connection> _connection;
+
+        /// @brief Открытое соединение; переподключается, если прежнее оборвалось
+        pqxx::connection& GetConnection();
+
+        /// @brief Выполнить fn(connection) под мьютексом. При обрыве соединения оно
+        /// сбрасывается, а ошибка пробрасывается: повтор пойдет через новое соединение
+        template <typename Fn>
+        auto WithConnection(Fn&& fn);
+    };
+}
@@ -0,0 +1,188 @@
+#include "records.h"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+namespace records {
+
+using namespace std::literals;
+
+RecordsWriter::RecordsWriter(RecordsRepository& repository, RecordsWriterConfig config, ErrorHandler onError)
+    : _repository {repository}, _config {config}, _onError {std::move(onError)} {
+    _config.maxBatch = std::max<size_t>(_config.maxBatch, 1);
+    _config.maxAttempts = std::max(_config.maxAttempts, 1u);
+    _config.maxFailedPeriods = std::max(_config.maxFailedPeriods, 1u);
+
+    _thread = std::thread([this] { Run(); });
+}
+
+RecordsWriter::~RecordsWriter() {
+    Stop();
+}
+
+size_t RecordsWriter::Push(std::vector<Record> records) {
+    size_t accepted = 0;
+    size_t dropped = 0;
+
+    {
+        std::lock_guard lock {_mutex};
+
+        const size_t used = _pending.size() + _inFlight;
+        const size_t free = used < _config.capacity ? _config.capacity - used : 0;
+
+        accepted = std::min(records.size(), free);
+        dropped = records.size() - accepted;
+
+        std::move(records.begin(), records.begin() + accepted, std::back_inserter(_pending));
+        _dropped += dropped;
+
+        if (_pending.size() >= _config.maxBatch) {
+            _wakeUp.notify_one();
+        }
+    }
+
+    if (dropped > 0 && _onError) {
+        _onError("records queue is full, dropped "s + std::to_string(dropped) + " records"s);
+    }
+
+    return accepted;
+}
+
+void RecordsWriter::Stop() {
+    {
+        std::lock_guard lock {_mutex};
+        _stopping = true;
+    }
+
+    _wakeUp.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+size_t RecordsWriter::GetDropped() const {
+    std::lock_guard lock {_mutex};
+    return _dropped;
+}
+
+size_t RecordsWriter::GetPending() const {
+    std::lock_guard lock {_mutex};
+    return _pending.size() + _inFlight;
+}
+
+void RecordsWriter::Run() {
+    std::unique_lock lock {_mutex};
+
+    auto deadline = std::chrono::steady_clock::now() + _config.flushPeriod;
+    // после неудачной записи очередь ждет весь период, даже если в ней полная пачка
+    bool failed = false;
+    // периодов подряд, в которые не удалось записать первую пачку
+    unsigned failedPeriods = 0;
+
+    while (true) {
+        _wakeUp.wait_until(lock, deadline, [this, &failed] {
+            return _stopping || (!failed && _pending.size() >= _config.maxBatch);
+        });
+
+        failed = false;
+
+        const bool stopping = _stopping;
+
+        while (!_pending.empty()) {
+            const size_t count = std::min(_pending.size(), _config.maxBatch);
+
+            std::vector<Record> batch {std::make_move_iterator(_pending.begin()),
+                                       std::make_move_iterator(_pending.begin() + count)};
+            _pending.erase(_pending.begin(), _pending.begin() + count);
+
+            if (WriteBatch(batch, lock)) {
+                failedPeriods = 0;
+                continue;
+            }
+
+            if (stopping) {
+                // хранилище недоступно, а ждать больше нельзя
+                _dropped += batch.size() + _pending.size();
+                _pending.clear();
+                break;
+            }
+
+            failed = true;
+
+            if (++failedPeriods >= _config.maxFailedPeriods) {
+                // пачку, которую хранилище не принимает (например, из-за одной
+                // неподходящей записи), не держим в начале очереди вечно
+                failedPeriods = 0;
+                _dropped += batch.size();
+
+                if (_onError) {
+                    lock.unlock();
+                    _onError("records batch dropped after "s + std::to_string(_config.maxFailedPeriods)
+                             + " failed periods: "s + std::to_string(batch.size()) + " records"s);
+                    lock.lock();
+                }
+
+                break;
+            }
+
+            // повторим в следующий период; порядок результатов сохраняется
+            _pending.insert(_pending.begin(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+            break;
+        }
+
+        if (stopping) {
+            return;
+        }
+
+        deadline = std::chrono::steady_clock::now() + _config.flushPeriod;
+    }
+}
+
+bool RecordsWriter::WriteBatch(const std::vector<Record>& batch, std::unique_lock<std::mutex>& lock) {
+    auto delay = _config.retryDelay;
+
+    _inFlight = batch.size();
+
+    for (unsigned attempt = 1; attempt <= _config.maxAttempts; ++attempt) {
+        bool saved = false;
+        std::string error;
+
+        // хранилище пишет без блокировки: Push в это время не ждет
+        lock.unlock();
+
+        try {
+            _repository.Save(batch);
+            saved = true;
+        } catch (const std::exception& ex) {
+            error = ex.what();
+        } catch (...) {
+            // исключение не из std::exception не должно завершить поток записи
+            error = "unknown error"s;
+        }
+
+        if (saved) {
+            lock.lock();
+            _inFlight = 0;
+            return true;
+        }
+
+        if (_onError) {
+            _onError("failed to save records: "s + error);
+        }
+
+        lock.lock();
+
+        if (attempt < _config.maxAttempts) {
+            // при остановке не ждем полную паузу
+            _wakeUp.wait_for(lock, delay, [this] { return _stopping; });
+            delay *= 2;
+        }
+    }
+
+    _inFlight = 0;
+    return false;
+}
+
+}  // namespace records
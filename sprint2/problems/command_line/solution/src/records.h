@@ -0,0 +1,106 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace records {
+
+    /// @brief Длина имени в байтах, которая помещается в столбец name хранилища
+    constexpr size_t MAX_NAME_LENGTH = 100;
+
+    /// @brief Результат ушедшего игрока
+    struct Record {
+        std::string name;
+        uint64_t score = 0;
+        // время в игре, мс
+        int64_t playTime = 0;
+    };
+
+    /// @brief Постоянное хранилище результатов
+    class RecordsRepository {
+    public:
+        /// @brief Сохранить пачку результатов в одной транзакции. При ошибке бросает исключение,
+        /// и ни один результат пачки не сохраняется
+        virtual void Save(const std::vector<Record>& records) = 0;
+
+        /// @brief Не больше maxItems результатов с места start: по убыванию очков,
+        /// при равенстве - по возрастанию времени в игре, затем по имени
+        virtual std::vector<Record> Load(size_t start, size_t maxItems) = 0;
+
+    protected:
+        ~RecordsRepository() = default;
+    };
+
+    /// @brief Настройки фоновой записи результатов
+    struct RecordsWriterConfig {
+        // как часто накопленные результаты уходят в хранилище
+        std::chrono::milliseconds flushPeriod {500};
+        // больше результатов в одной транзакции не пишется; полная пачка уходит не дожидаясь периода
+        size_t maxBatch = 1000;
+        // результатов в очереди, после которого новые отбрасываются
+        size_t capacity = 100'000;
+        // попыток записать пачку подряд; пауза между попытками растет вдвое
+        unsigned maxAttempts = 3;
+        std::chrono::milliseconds retryDelay {100};
+        // периодов подряд, за которые не удалось записать первую пачку очереди; после этого
+        // пачка отбрасывается, чтобы не задерживать результаты за ней
+        unsigned maxFailedPeriods = 5;
+    };
+
+    /// @brief Фоновая запись результатов: Push только ставит результаты в очередь и
+    /// вызывается из strand игры, отдельный поток раз в flushPeriod пишет накопленное
+    /// пачками в одной транзакции. Пачка, которую не удалось записать за maxAttempts
+    /// попыток, возвращается в начало очереди до следующего периода, а после maxFailedPeriods
+    /// таких периодов отбрасывается; очередь ограничена capacity, поэтому при долгой
+    /// недоступности хранилища новые результаты тоже отбрасываются.
+    class RecordsWriter {
+    public:
+        using ErrorHandler = std::function<void(const std::string& message)>;
+
+        RecordsWriter(RecordsRepository& repository, RecordsWriterConfig config = {}, ErrorHandler onError = {});
+
+        RecordsWriter(const RecordsWriter&) = delete;
+        RecordsWriter& operator=(const RecordsWriter&) = delete;
+
+        /// @brief Останавливает поток, перед этим пытается записать все, что осталось в очереди
+        ~RecordsWriter();
+
+        /// @brief Поставить результаты в очередь.
+        /// @return сколько результатов принято; остальные отброшены из-за переполнения очереди
+        size_t Push(std::vector<Record> records);
+
+        /// @brief Записать очередь и остановить поток. Повторный вызов ничего не делает
+        void Stop();
+
+        /// @brief Результатов, отброшенных из-за переполнения очереди или неудачной записи
+        size_t GetDropped() const;
+
+        size_t GetPending() const;
+
+    private:
+        RecordsRepository& _repository;
+        RecordsWriterConfig _config;
+        ErrorHandler _onError;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _wakeUp;
+        std::deque<Record> _pending;
+        // результатов в пачке, которая сейчас пишется: они тоже занимают место в очереди
+        size_t _inFlight = 0;
+        size_t _dropped = 0;
+        bool _stopping = false;
+
+        std::thread _thread;
+
+        void Run();
+
+        /// @brief Записать пачку с повторами. false - все попытки не удались
+        bool WriteBatch(const std::vector<Record>& batch, std::unique_lock<std::mutex>& lock);
+    };
+}
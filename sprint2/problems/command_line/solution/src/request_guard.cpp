@@ -0,0 +1,90 @@
+#include "request_guard.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace http_handler {
+
+    double RateLimiter::Refill(const Bucket& bucket, Clock::time_point now) const {
+        const std::chrono::duration<double> elapsed = now - bucket.updated;
+
+        return std::min(_burst, bucket.tokens + std::max(0.0, elapsed.count()) * _rate);
+    }
+
+    bool RateLimiter::TryAcquire(std::string_view token, Clock::time_point now){
+        auto& shard = _shards[std::hash<std::string_view>{}(token) % _shards.size()];
+
+        std::lock_guard lock {shard.mutex};
+
+        if (shard.buckets.size() >= MAX_SHARD_SIZE){
+            std::erase_if(shard.buckets, [this, now](const auto& item){
+                return Refill(item.second, now) >= _burst;
+            });
+        }
+
+        auto [it, inserted] = shard.buckets.try_emplace(std::string(token), Bucket {_burst, now});
+
+        auto& bucket = it->second;
+
+        bucket.tokens = Refill(bucket, now);
+        bucket.updated = now;
+
+        if (bucket.tokens < 1){
+            return false;
+        }
+
+        bucket.tokens -= 1;
+
+        return true;
+    }
+
+    RequestGuard::Decision RequestGuard::Admit(std::string_view token, Clock::time_point now){
+        if (IsOverloaded()){
+            ++_shed;
+
+            return Decision::Shed;
+        }
+
+        if (!token.empty() && !_limiter.TryAcquire(token, now)){
+            ++_throttled;
+
+            return Decision::Throttle;
+        }
+
+        ++_queueDepth;
+
+        return Decision::Accept;
+    }
+
+    void RequestGuard::OnDequeued(Clock::duration wait){
+        --_queueDepth;
+
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+
+        // экспоненциальное среднее с весом 1/8 для нового значения
+        const auto average = _queueWait.load(std::memory_order_relaxed);
+
+        _queueWait.store(average + (micros - average) / 8, std::memory_order_relaxed);
+    }
+
+    bool RequestGuard::IsOverloaded() const noexcept {
+        const size_t depth = _queueDepth;
+
+        if (depth >= _config.maxQueueDepth){
+            return true;
+        }
+
+        // пока очередь не пуста, высокое среднее ожидание означает, что strand не успевает;
+        // на пустой очереди новые запросы обновят среднее, и режим перегрузки снимется
+        return depth > 0 && std::chrono::microseconds {_queueWait.load(std::memory_order_relaxed)} > _config.maxQueueWait;
+    }
+
+    RequestCounters RequestGuard::GetCounters() const {
+        return {
+            _throttled.load(),
+            _shed.load(),
+            _queueDepth.load(),
+            _queueWait.load() / 1000.0
+        };
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace http_handler {
+
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Ограничение частоты запросов по токену игрока (token bucket).
+    /// Потокобезопасен и вызывается до постановки запроса в strand приложения,
+    /// поэтому хранит корзины сам, в нескольких независимо блокируемых частях.
+    class RateLimiter {
+    public:
+        RateLimiter(double tokensPerSecond, double burst) : _rate {tokensPerSecond}, _burst {burst} {};
+
+        RateLimiter(const RateLimiter&) = delete;
+        RateLimiter& operator=(const RateLimiter&) = delete;
+
+        /// @brief Списать один запрос с корзины токена. false - лимит исчерпан
+        bool TryAcquire(std::string_view token, Clock::time_point now);
+
+    private:
+        // корзин в одной части, после которого полные (неотличимые от новых) корзины удаляются
+        static constexpr size_t MAX_SHARD_SIZE = 4096;
+
+        struct Bucket {
+            double tokens;
+            Clock::time_point updated;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<std::string, Bucket> buckets;
+        };
+
+        double _rate;
+        double _burst;
+        std::array<Shard, 16> _shards;
+
+        double Refill(const Bucket& bucket, Clock::time_point now) const;
+    };
+
+    /// @brief Настройки защиты от перегрузки
+    struct RequestGuardConfig {
+        // запросов в секунду на один токен и допустимый всплеск
+        double tokensPerSecond = 50;
+        double burst = 100;
+        // запросов, ожидающих strand, после которого новые отклоняются
+        size_t maxQueueDepth = 2048;
+        // среднее ожидание в очереди strand, после которого новые запросы отклоняются
+        std::chrono::milliseconds maxQueueWait {250};
+        std::chrono::seconds retryAfter {1};
+    };
+
+    /// @brief Счетчики для /api/v1/metrics
+    struct RequestCounters {
+        uint64_t throttled;
+        uint64_t shed;
+        size_t queueDepth;
+        double queueWaitMs;
+    };
+
+    /// @brief Решение о приеме API-запроса до постановки в strand: лимит на токен
+    /// и режим перегрузки по глубине очереди strand и времени ожидания в ней.
+    class RequestGuard {
+    public:
+        enum class Decision {
+            Accept,
+            // превышен лимит токена - 429
+            Throttle,
+            // сервер перегружен - 503
+            Shed
+        };
+
+        explicit RequestGuard(RequestGuardConfig config = {}) :
+            _config {config}, _limiter {config.tokensPerSecond, config.burst} {};
+
+        RequestGuard(const RequestGuard&) = delete;
+        RequestGuard& operator=(const RequestGuard&) = delete;
+
+        /// @brief Принять или отклонить запрос. Принятый запрос считается стоящим
+        /// в очереди strand до вызова OnDequeued. Пустой token - запрос без авторизации.
+        Decision Admit(std::string_view token, Clock::time_point now = Clock::now());
+
+        /// @brief Запрос начал выполняться в strand после ожидания wait
+        void OnDequeued(Clock::duration wait);
+
+        /// @brief Принятый запрос выполняется вне strand: он уходит из очереди,
+        /// не меняя среднее ожидание в ней
+        void OnBypassed() noexcept {
+            --_queueDepth;
+        }
+
+        RequestCounters GetCounters() const;
+
+        /// @brief Число принятых запросов, ожидающих strand
+        size_t GetQueueDepth() const noexcept {
+            return _queueDepth.load(std::memory_order_relaxed);
+        }
+
+        std::chrono::seconds GetRetryAfter() const noexcept {
+            return _config.retryAfter;
+        }
+
+    private:
+        RequestGuardConfig _config;
+        RateLimiter _limiter;
+        std::atomic_size_t _queueDepth = 0;
+        // скользящее среднее ожидания в очереди, мкс; пишется только из strand
+        std::atomic<int64_t> _queueWait = 0;
+        std::atomic<uint64_t> _throttled = 0;
+        std::atomic<uint64_t> _shed = 0;
+
+        bool IsOverloaded() const noexcept;
+    };
+}
@@ -41,5 +41,22 @@ std::string_view mime_type(fs::path path)
     return "application/octet-stream";
 };
 
+StringResponse Rejected(unsigned version, bool keepAlive, RequestGuard::Decision decision, std::chrono::seconds retryAfter) {
+    const bool throttled = decision == RequestGuard::Decision::Throttle;
+
+    auto error = throttled
+        ? dto::ErrorDto {"tooManyRequests"s, "Request rate limit exceeded"s}
+        : dto::ErrorDto {"serverOverloaded"s, "Server is overloaded, retry later"s};
+
+    StringResponse response {throttled ? http::status::too_many_requests : http::status::service_unavailable, version};
+    response.set(http::field::content_type, "application/json");
+    response.set(http::field::cache_control, "no-cache");
+    response.set(http::field::retry_after, std::to_string(retryAfter.count()));
+    response.body() = json::serialize(json::value_from(error));
+    response.keep_alive(keepAlive);
+    response.prepare_payload();
+    return response;
+}
+
 StaticFileRequestHandler::StaticFileRequestHandler(fs::path wwwroot) : wwwroot_(wwwroot) {};
 }  // namespace http_handler
@@ -3,16 +3,20 @@
 #include <filesystem>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include "http_server.h"
 #include "model.h"
 #include "dto.h"
 #include "file_utils.h"
 #include "logger.h"
 #include "api_handler.h"
+#include "request_guard.h"
+#include "strand_metrics.h"
 
 #define BOOST_URL_NO_LIB
 #include <boost/url.hpp>
 #include <boost/json.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #define BOOST_BEAST_USE_STD_STRING_VIEW
 
@@ -34,6 +38,9 @@ using namespace std::literals;
 
 std::string_view mime_type(fs::path path);
 
+/// @brief Ответ на запрос, отклоненный защитой от перегрузки: 429 или 503 с Retry-After
+StringResponse Rejected(unsigned version, bool keepAlive, RequestGuard::Decision decision, std::chrono::seconds retryAfter);
+
 template <typename Body, typename Allocator>
 StringResponse BadRequest(const http::request<Body, http::basic_fields<Allocator>>& request, const std::string& message) {
     StringResponse response { http::status::bad_request, request.version()};
@@ -150,6 +157,12 @@ private:
     fs::path wwwroot_;
 };
 
+/// @brief Хранилище рекордов и пул потоков, в котором выполняются запросы к нему
+struct RecordsBackend {
+    records::RecordsRepository& repository;
+    net::thread_pool::executor_type executor;
+};
+
 class RequestHandler :  public std::enable_shared_from_this<RequestHandler> {
 public:
 
@@ -158,10 +171,15 @@ public:
     using FileResponse = http::response<http::file_body>;
     using Strand = boost::asio::strand<boost::asio::io_context::executor_type>;
 
-    explicit RequestHandler(ApiHandler&& apiHandler, StaticFileRequestHandler&& staticHandler, Strand strand) :
+    /// @param records хранилище рекордов; nullopt - рекорды не хранятся
+    explicit RequestHandler(ApiHandler&& apiHandler, StaticFileRequestHandler&& staticHandler, Strand strand, RequestGuard& guard, StrandMetrics& strandMetrics,
+                            std::optional<RecordsBackend> records = std::nullopt) :
         _apiHandler{std::forward<ApiHandler>(apiHandler)}, 
         _staticFileHandler(std::forward<StaticFileRequestHandler>(staticHandler)),
-        _strand {strand} {}
+        _strand {strand},
+        _guard {guard},
+        _strandMetrics {strandMetrics},
+        _records {records} {}
         
 
     RequestHandler(const RequestHandler&) = delete;
@@ -170,15 +188,48 @@ public:
     RequestHandler(RequestHandler&& other) : 
         _apiHandler(std::forward<ApiHandler>(other._apiHandler)),
         _staticFileHandler(std::forward<StaticFileRequestHandler>(other._staticFileHandler)),
-        _strand { other._strand} {}
+        _strand { other._strand},
+        _guard { other._guard},
+        _strandMetrics { other._strandMetrics},
+        _records { other._records} {}
 
     template <typename Body, typename Allocator, typename ResponseWriter>
     void operator()(http::request<Body, http::basic_fields<Allocator>>&& request, ResponseWriter&& writer) {
+        if (_records && IsRecordsRequest(request.target())){
+            if (!Admit(request, writer)){
+                return;
+            }
+
+            // рекорды читаются из базы и не зависят от состояния игры: запрос выполняется
+            // в пуле рекордов, не занимая ни strand, ни потоки, обслуживающие сокеты
+            _guard.OnBypassed();
+
+            net::post(_records->executor, [self = shared_from_this(), req = std::forward<decltype(request)>(request), writer] () mutable {
+                writer(HandleGetRecords(self->_records->repository, std::move(req)));
+            });
+
+            return;
+        }
+
         if (_apiHandler.IsApiRequest(request.target())){
+            if (!Admit(request, writer)){
+                return;
+            }
+
+            // Admit уже учел этот запрос в глубине очереди
+            _strandMetrics.OnEnqueued(_guard.GetQueueDepth() - 1);
+
+            std::string target = request.target();
+
             auto handle = [self = shared_from_this(), req = std::forward<decltype(request)>(request), 
-                           writer] () mutable {
+                           writer, route = GetRouteIndex(target), enqueued = Clock::now()] () mutable {
                 assert(self->_strand.running_in_this_thread());
+
+                const auto dequeued = Clock::now();
+
+                self->_guard.OnDequeued(dequeued - enqueued);
                 self->_apiHandler(std::move(req), writer);
+                self->_strandMetrics.OnCompleted(route, dequeued - enqueued, Clock::now() - dequeued);
             };
 
             net::dispatch(_strand, handle);
@@ -192,6 +243,30 @@ private:
     ApiHandler _apiHandler;
     StaticFileRequestHandler _staticFileHandler;
     Strand _strand;
+    RequestGuard& _guard;
+    StrandMetrics& _strandMetrics;
+    std::optional<RecordsBackend> _records;
+
+    // лимит на токен и режим перегрузки проверяются до очереди strand или пула рекордов,
+    // чтобы отклоненный запрос не занимал их. false - запрос отклонен и ответ уже отправлен
+    template <typename Request, typename ResponseWriter>
+    bool Admit(const Request& request, ResponseWriter& writer) {
+        std::string authorization = request[http::field::authorization];
+
+        auto decision = _guard.Admit(GetBearerToken(authorization));
+
+        if (decision != RequestGuard::Decision::Accept){
+            writer(Rejected(request.version(), request.keep_alive(), decision, _guard.GetRetryAfter()));
+
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool IsRecordsRequest(std::string_view target) {
+        return target.substr(0, target.find('?')) == "/api/v1/game/records"sv;
+    }
 };
 
 }  // namespace http_handler
@@ -0,0 +1,119 @@
+#include "road_graph.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+
+namespace model {
+
+namespace {
+
+// половина ширины дороги
+constexpr double ROAD_HALF_WIDTH = 0.4;
+
+RoadBounds GetBounds(const Road& road) {
+    return {
+        std::min(road.GetStart().x, road.GetEnd().x) - ROAD_HALF_WIDTH,
+        std::max(road.GetStart().x, road.GetEnd().x) + ROAD_HALF_WIDTH,
+        std::min(road.GetStart().y, road.GetEnd().y) - ROAD_HALF_WIDTH,
+        std::max(road.GetStart().y, road.GetEnd().y) + ROAD_HALF_WIDTH
+    };
+}
+
+// участок исходной дороги на прямой: [from, to] и индекс дороги на карте
+struct Span {
+    Coord from;
+    Coord to;
+    size_t source;
+};
+
+}  // namespace
+
+RoadGraph::RoadGraph(const Map::Roads& roads) {
+    MergeRoads(roads);
+    LinkRoads();
+}
+
+void RoadGraph::MergeRoads(const Map::Roads& roads) {
+    // прямые, на которых лежат дороги: y горизонтальных и x вертикальных
+    std::map<Coord, std::vector<Span>> horizontal;
+    std::map<Coord, std::vector<Span>> vertical;
+
+    for (size_t i = 0; i < roads.size(); ++i) {
+        const auto& road = roads[i];
+
+        if (road.IsHorizontal()) {
+            horizontal[road.GetStart().y].push_back(
+                {std::min(road.GetStart().x, road.GetEnd().x), std::max(road.GetStart().x, road.GetEnd().x), i});
+        } else {
+            vertical[road.GetStart().x].push_back(
+                {std::min(road.GetStart().y, road.GetEnd().y), std::max(road.GetStart().y, road.GetEnd().y), i});
+        }
+    }
+
+    _sourceToRoad.resize(roads.size());
+
+    auto merge = [this](std::map<Coord, std::vector<Span>>& lines, bool isHorizontal) {
+        for (auto& [line, spans] : lines) {
+            std::ranges::sort(spans, {}, &Span::from);
+
+            for (size_t i = 0; i < spans.size();) {
+                Coord to = spans[i].to;
+                size_t j = i;
+
+                // следующие участки, начинающиеся не дальше конца текущего, продолжают ту же дорогу
+                for (; j < spans.size() && spans[j].from <= to; ++j) {
+                    to = std::max(to, spans[j].to);
+                    _sourceToRoad[spans[j].source] = _roads.size();
+                }
+
+                const Road road = isHorizontal
+                    ? Road{Road::HORIZONTAL, Point{spans[i].from, line}, to}
+                    : Road{Road::VERTICAL, Point{line, spans[i].from}, to};
+
+                _roads.push_back(Segment{road, GetBounds(road), {}});
+
+                i = j;
+            }
+        }
+    };
+
+    merge(horizontal, true);
+    merge(vertical, false);
+}
+
+void RoadGraph::LinkRoads() {
+    // проход по дорогам, упорядоченным по левой границе: соседей дороги достаточно
+    // искать среди следующих, пока их левая граница не правее ее правой границы
+    std::vector<size_t> order(_roads.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, {}, [this](size_t index) { return _roads[index].bounds.x_min; });
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto& a = _roads[order[i]].bounds;
+
+        for (size_t j = i + 1; j < order.size() && _roads[order[j]].bounds.x_min <= a.x_max; ++j) {
+            const auto& b = _roads[order[j]].bounds;
+
+            if (b.y_min > a.y_max || a.y_min > b.y_max) {
+                continue;
+            }
+
+            const size_t node = _nodes.size();
+
+            _nodes.push_back(Node{
+                RoadBounds{
+                    std::max(a.x_min, b.x_min), std::min(a.x_max, b.x_max),
+                    std::max(a.y_min, b.y_min), std::min(a.y_max, b.y_max)
+                },
+                order[i],
+                order[j]
+            });
+
+            _roads[order[i]].links.push_back({order[j], node});
+            _roads[order[j]].links.push_back({order[i], node});
+        }
+    }
+}
+
+}  // namespace model
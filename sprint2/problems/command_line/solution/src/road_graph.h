@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include "model.h"
+
+namespace model {
+
+/// @brief Прямоугольник дороги с учетом ее ширины
+struct RoadBounds {
+    double x_min;
+    double x_max;
+    double y_min;
+    double y_max;
+};
+
+/// @brief Граф дорог карты. Строится один раз при загрузке карты:
+/// коллинеарные дороги, которые перекрываются или соприкасаются, объединяются в одну,
+/// для каждой дороги хранится список соседних дорог и общий с ними прямоугольник (узел).
+class RoadGraph {
+public:
+    struct Link {
+        // индекс соседней дороги
+        size_t road;
+        // индекс узла, в котором дороги пересекаются
+        size_t node;
+    };
+
+    struct Segment {
+        Road road;
+        RoadBounds bounds;
+        std::vector<Link> links;
+    };
+
+    struct Node {
+        // общая часть прямоугольников двух дорог
+        RoadBounds area;
+        size_t first;
+        size_t second;
+    };
+
+    explicit RoadGraph(const Map::Roads& roads);
+
+    const std::vector<Segment>& GetRoads() const noexcept {
+        return _roads;
+    }
+
+    const std::vector<Node>& GetNodes() const noexcept {
+        return _nodes;
+    }
+
+    /// @brief Индекс объединенной дороги, в которую вошла исходная дорога карты
+    size_t GetRoadOf(size_t sourceRoad) const {
+        return _sourceToRoad.at(sourceRoad);
+    }
+
+private:
+    std::vector<Segment> _roads;
+    std::vector<Node> _nodes;
+    std::vector<size_t> _sourceToRoad;
+
+    void MergeRoads(const Map::Roads& roads);
+
+    void LinkRoads();
+};
+
+}  // namespace model
@@ -0,0 +1,161 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+/// @brief Идентификатор элемента SlotMap
+using SlotId = uint64_t;
+
+/**
+ * Контейнер с поколенческими идентификаторами (slot map).
+ * Элементы лежат подряд в векторе, поэтому обход быстрый; удаление - O(1):
+ * на место удаленного элемента переносится последний.
+ *
+ * Идентификатор элемента - номер слота (начиная с 1) в младших 32 битах и поколение
+ * слота в старших. При удалении поколение слота увеличивается, поэтому старый
+ * идентификатор больше ничего не находит, даже если слот занят новым элементом.
+ * Идентификатор 0 никогда не выдается.
+ *
+ * Указатели и ссылки на элементы действительны только до следующей вставки или удаления,
+ * между вызовами нужно хранить идентификатор.
+ */
+template <typename T>
+class SlotMap {
+public:
+    using Id = SlotId;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /// @brief Идентификатор, который получит следующий вставленный элемент
+    Id PeekNextId() const noexcept {
+        const uint32_t slot = _freeHead != NO_SLOT ? _freeHead : static_cast<uint32_t>(_slots.size());
+        const uint32_t generation = slot < _slots.size() ? _slots[slot].generation : 0;
+
+        return MakeId(slot, generation);
+    }
+
+    template <typename... Args>
+    T& Emplace(Args&&... args) {
+        const uint32_t slot = _freeHead != NO_SLOT ? _freeHead : static_cast<uint32_t>(_slots.size());
+
+        _values.emplace_back(std::forward<Args>(args)...);
+        _valueSlots.push_back(slot);
+
+        if (slot == _slots.size()) {
+            _slots.push_back(Slot{0, 0});
+        } else {
+            _freeHead = _slots[slot].index;
+        }
+
+        _slots[slot].index = static_cast<uint32_t>(_values.size() - 1);
+
+        return _values.back();
+    }
+
+    T* Find(Id id) noexcept {
+        const uint32_t index = FindIndex(id);
+
+        return index == NO_SLOT ? nullptr : &_values[index];
+    }
+
+    const T* Find(Id id) const noexcept {
+        const uint32_t index = FindIndex(id);
+
+        return index == NO_SLOT ? nullptr : &_values[index];
+    }
+
+    /// @brief Удалить элемент. false, если идентификатор устарел или не выдавался
+    bool Erase(Id id) {
+        const uint32_t index = FindIndex(id);
+
+        if (index == NO_SLOT) {
+            return false;
+        }
+
+        const uint32_t slot = _valueSlots[index];
+        const uint32_t last = static_cast<uint32_t>(_values.size() - 1);
+
+        if (index != last) {
+            _values[index] = std::move(_values[last]);
+            _valueSlots[index] = _valueSlots[last];
+            _slots[_valueSlots[index]].index = index;
+        }
+
+        _values.pop_back();
+        _valueSlots.pop_back();
+
+        ++_slots[slot].generation;
+        _slots[slot].index = _freeHead;
+        _freeHead = slot;
+
+        return true;
+    }
+
+    size_t size() const noexcept {
+        return _values.size();
+    }
+
+    bool empty() const noexcept {
+        return _values.empty();
+    }
+
+    iterator begin() noexcept {
+        return _values.begin();
+    }
+
+    iterator end() noexcept {
+        return _values.end();
+    }
+
+    const_iterator begin() const noexcept {
+        return _values.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return _values.end();
+    }
+
+private:
+    static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+    struct Slot {
+        // занятый слот - индекс элемента, свободный - следующий свободный слот
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    std::vector<T> _values;
+    // слот каждого элемента
+    std::vector<uint32_t> _valueSlots;
+    std::vector<Slot> _slots;
+    uint32_t _freeHead = NO_SLOT;
+
+    static Id MakeId(uint32_t slot, uint32_t generation) noexcept {
+        return (static_cast<Id>(generation) << 32) | (static_cast<Id>(slot) + 1);
+    }
+
+    uint32_t FindIndex(Id id) const noexcept {
+        const auto low = static_cast<uint32_t>(id);
+
+        if (low == 0 || low > _slots.size()) {
+            return NO_SLOT;
+        }
+
+        const auto& slot = _slots[low - 1];
+
+        // поколение меняется при удалении; проверка обратной ссылки отсекает свободный слот,
+        // для которого запрошен еще не выданный идентификатор
+        if (slot.generation != static_cast<uint32_t>(id >> 32)
+            || slot.index >= _values.size() || _valueSlots[slot.index] != low - 1) {
+            return NO_SLOT;
+        }
+
+        return slot.index;
+    }
+};
+
+}  // namespace util
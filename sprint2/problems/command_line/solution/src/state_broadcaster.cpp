@@ -0,0 +1,169 @@
+#include "state_broadcaster.h"
+#include "api_handler.h"
+#include "json_writer.h"
+#include "request_handler.h"
+#include <boost/asio/dispatch.hpp>
+
+namespace http_handler {
+using namespace std::literals;
+
+    std::optional<std::string> GetWebSocketToken(const http_server::WebSocketSession::HttpRequest& request){
+        std::string authorization = request[http::field::authorization];
+
+        // переданный заголовок должен содержать корректный токен
+        if (!authorization.empty()){
+            auto token = GetBearerToken(authorization);
+
+            return token.empty() ? std::nullopt : std::optional<std::string>{token};
+        }
+
+        // браузерный WebSocket API не позволяет задать заголовки, поэтому токен можно передать в запросе
+        std::string target = request.target();
+
+        auto token = GetQueryParameter(target, "token"sv);
+
+        return token && IsValidToken(*token) ? token : std::nullopt;
+    }
+
+    http_server::WebSocketSession::Frame MakeStateFrame(model::GameSession& session, std::optional<uint64_t> since){
+        std::string frame;
+
+        json_writer::WriteVersionedGameState(frame, session, since);
+
+        return std::make_shared<const std::string>(std::move(frame));
+    }
+
+    void StateBroadcaster::Subscribe(WebSocketSessionPtr session, const WebSocketRequest& request){
+        std::string target = request.target();
+
+        auto token = GetWebSocketToken(request);
+
+        if (!target.starts_with("/api/v1/game/state/ws"sv) || !token){
+            session->Close();
+
+            return;
+        }
+
+        net::dispatch(_strand, [self = shared_from_this(), session = std::move(session), token = std::move(*token)]{
+            auto player = self->_application.FindPlayerByToken(token);
+
+            auto gameSession = player ? self->_application.GetSession(player->sessionId) : nullptr;
+
+            if (!gameSession){
+                session->Close();
+
+                return;
+            }
+
+            // первый кадр - полное текущее состояние, не дожидаясь тика
+            session->Send(MakeStateFrame(*gameSession, std::nullopt));
+
+            // изменения, еще не разосланные остальным подписчикам, новому подписчику
+            // придут повторно - состояние собак абсолютное, повтор безопасен
+            auto [it, inserted] = self->_subscribers.try_emplace(player->sessionId);
+
+            if (inserted){
+                it->second.version = gameSession->GetVersion();
+            }
+
+            it->second.sessions.emplace_back(Subscriber {session, player->id, session->GetDroppedFrames()});
+        });
+    }
+
+    void StateBroadcaster::Broadcast(){
+        for (auto it = _subscribers.begin(); it != _subscribers.end();){
+            auto& [sessionId, subscribers] = *it;
+
+            std::erase_if(subscribers.sessions, [](const auto& subscriber){
+                auto session = subscriber.session.lock();
+
+                return !session || !session->IsOpen();
+            });
+
+            auto gameSession = _application.GetSession(sessionId);
+
+            if (subscribers.sessions.empty() || !gameSession){
+                it = _subscribers.erase(it);
+
+                continue;
+            }
+
+            if (gameSession->GetVersion() == subscribers.version){
+                ++it;
+
+                continue;
+            }
+
+            // один буфер с изменениями с прошлой рассылки на всех подписчиков сессии
+            auto delta = MakeStateFrame(*gameSession, subscribers.version);
+
+            Frame snapshot;
+
+            for (auto& subscriber : subscribers.sessions){
+                auto session = subscriber.session.lock();
+
+                if (!session){
+                    continue;
+                }
+
+                // клиент пропустил кадры - дельта к его состоянию неприменима, отправляем снимок
+                if (auto dropped = session->GetDroppedFrames(); dropped != subscriber.droppedFrames){
+                    subscriber.droppedFrames = dropped;
+
+                    if (!snapshot){
+                        snapshot = MakeStateFrame(*gameSession, std::nullopt);
+                    }
+
+                    session->Send(snapshot);
+
+                    continue;
+                }
+
+                session->Send(delta);
+            }
+
+            subscribers.version = gameSession->GetVersion();
+
+            ++it;
+        }
+    }
+
+    void StateBroadcaster::Unsubscribe(const std::vector<app::RetiredPlayer>& players){
+        for (const auto& retired : players){
+            auto it = _subscribers.find(retired.player.sessionId);
+
+            if (it == _subscribers.end()){
+                continue;
+            }
+
+            // ушедший игрок больше не видит игру: соединение закрывается сразу,
+            // а не когда опустеет вся игровая сессия
+            std::erase_if(it->second.sessions, [&retired](const auto& subscriber){
+                if (subscriber.playerId != retired.player.id){
+                    return false;
+                }
+
+                if (auto session = subscriber.session.lock()){
+                    session->Close();
+                }
+
+                return true;
+            });
+        }
+    }
+
+    std::optional<http::response<http::string_body>> WebSocketHandler::Admit(const WebSocketRequest& request){
+        auto token = GetWebSocketToken(request);
+
+        auto decision = _guard.Admit(token ? std::string_view {*token} : std::string_view {});
+
+        if (decision != RequestGuard::Decision::Accept){
+            return Rejected(request.version(), request.keep_alive(), decision, _guard.GetRetryAfter());
+        }
+
+        // подписка не ждет в очереди strand вместе с API-запросами
+        _guard.OnBypassed();
+
+        return std::nullopt;
+    }
+}
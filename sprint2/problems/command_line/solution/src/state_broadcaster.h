@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+#include "application.h"
+#include "request_guard.h"
+#include "websocket_session.h"
+
+namespace http_handler {
+    namespace net = boost::asio;
+    namespace http = boost::beast::http;
+
+    /// @brief Рассылка состояния игры по WebSocket после каждого тика.
+    /// Изменения с прошлой рассылки сериализуются один раз на игровую сессию
+    /// и разделяются между подписчиками; пропустившие кадры получают полный снимок.
+    class StateBroadcaster : public std::enable_shared_from_this<StateBroadcaster> {
+        using Strand = net::strand<net::io_context::executor_type>;
+        using WebSocketSessionPtr = std::shared_ptr<http_server::WebSocketSession>;
+        using WebSocketRequest = http_server::WebSocketSession::HttpRequest;
+        using Frame = http_server::WebSocketSession::Frame;
+
+        struct Subscriber {
+            std::weak_ptr<http_server::WebSocketSession> session;
+            // игрок, по токену которого подписано соединение
+            model::PlayerId playerId;
+            // число отброшенных кадров на момент последней отправки
+            size_t droppedFrames;
+        };
+
+        struct SessionSubscribers {
+            std::vector<Subscriber> sessions;
+            // версия игровой сессии, разосланная подписчикам
+            uint64_t version = 0;
+        };
+
+        app::Application& _application;
+        Strand _strand;
+        std::unordered_map<model::SessionId, SessionSubscribers> _subscribers;
+
+        public:
+        StateBroadcaster(app::Application& application, Strand strand) : _application {application}, _strand {strand} {};
+
+        StateBroadcaster(const StateBroadcaster&) = delete;
+        StateBroadcaster& operator=(const StateBroadcaster&) = delete;
+
+        /// @brief Подписать соединение на состояние сессии игрока. Токен берется
+        /// из заголовка Authorization или параметра token в строке запроса.
+        void Subscribe(WebSocketSessionPtr session, const WebSocketRequest& request);
+
+        /// @brief Разослать текущее состояние подписчикам. Вызывается в strand приложения.
+        void Broadcast();
+
+        /// @brief Закрыть соединения ушедших игроков. Вызывается в strand приложения.
+        void Unsubscribe(const std::vector<app::RetiredPlayer>& players);
+    };
+
+    /// @brief Обработчик WebSocket-подключений для http_server: upgrade проходит
+    /// RequestGuard до handshake, принятое соединение подписывается на состояние игры
+    class WebSocketHandler {
+        using WebSocketSessionPtr = std::shared_ptr<http_server::WebSocketSession>;
+        using WebSocketRequest = http_server::WebSocketSession::HttpRequest;
+
+        std::shared_ptr<StateBroadcaster> _broadcaster;
+        RequestGuard& _guard;
+
+        public:
+        WebSocketHandler(std::shared_ptr<StateBroadcaster> broadcaster, RequestGuard& guard) :
+            _broadcaster {std::move(broadcaster)}, _guard {guard} {};
+
+        /// @brief Лимит на токен и режим перегрузки, как у API-запросов.
+        /// nullopt - подключение принято, иначе ответ 429 или 503 вместо upgrade
+        std::optional<http::response<http::string_body>> Admit(const WebSocketRequest& request);
+
+        void operator()(WebSocketSessionPtr session, const WebSocketRequest& request) {
+            _broadcaster->Subscribe(std::move(session), request);
+        }
+    };
+}
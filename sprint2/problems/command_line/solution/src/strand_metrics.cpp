@@ -0,0 +1,62 @@
+#include "strand_metrics.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace http_handler {
+
+    namespace {
+        // границы корзин времени, мкс: от 50 мкс до 1 с
+        constexpr std::array<uint64_t, 14> DURATION_BOUNDS {
+            50, 100, 250, 500, 1'000, 2'500, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000, 500'000, 1'000'000
+        };
+
+        // границы корзин глубины очереди
+        constexpr std::array<uint64_t, 13> DEPTH_BOUNDS {
+            0, 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048
+        };
+
+        static_assert(DURATION_BOUNDS.size() <= Histogram::MAX_BOUNDS && DEPTH_BOUNDS.size() <= Histogram::MAX_BOUNDS);
+
+        template <size_t... Index>
+        auto MakeRoutes(std::index_sequence<Index...>) {
+            return std::array<StrandMetrics::RouteMetrics, sizeof...(Index)> {
+                ((void)Index, StrandMetrics::RouteMetrics {Histogram {DURATION_BOUNDS}, Histogram {DURATION_BOUNDS}})...
+            };
+        }
+
+        uint64_t ToMicroseconds(StrandMetrics::Clock::duration duration) noexcept {
+            return static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+        }
+    }
+
+    void Histogram::Record(uint64_t value) noexcept {
+        const auto bucket = std::ranges::lower_bound(_bounds, value) - _bounds.begin();
+
+        _counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        _total.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    size_t GetRouteIndex(std::string_view target) noexcept {
+        const auto path = target.substr(0, target.find('?'));
+
+        // /api/v1/maps/{id} - единственный маршрут с параметром в пути
+        if (path.starts_with("/api/v1/maps/") && path.size() > std::string_view{"/api/v1/maps/"}.size()){
+            return 1;
+        }
+
+        const auto route = std::ranges::find(API_ROUTES, path);
+
+        return route == API_ROUTES.end() ? API_ROUTES.size() - 1 : route - API_ROUTES.begin();
+    }
+
+    StrandMetrics::StrandMetrics() :
+        _depthHistogram {DEPTH_BOUNDS},
+        _routes {MakeRoutes(std::make_index_sequence<API_ROUTES.size()>{})} {};
+
+    void StrandMetrics::OnCompleted(size_t route, Clock::duration wait, Clock::duration execution) noexcept {
+        _routes[route].wait.Record(ToMicroseconds(wait));
+        _routes[route].execution.Record(ToMicroseconds(execution));
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace http_handler {
+
+    /// @brief Гистограмма с фиксированными верхними границами корзин.
+    /// Последняя корзина - значения больше всех границ. Потокобезопасна.
+    class Histogram {
+    public:
+        static constexpr size_t MAX_BOUNDS = 16;
+
+        explicit Histogram(std::span<const uint64_t> bounds) : _bounds {bounds} {};
+
+        void Record(uint64_t value) noexcept;
+
+        std::span<const uint64_t> GetBounds() const noexcept {
+            return _bounds;
+        }
+
+        /// @brief Число значений в корзине index, index == GetBounds().size() - больше всех границ
+        uint64_t GetCount(size_t index) const noexcept {
+            return _counts[index].load(std::memory_order_relaxed);
+        }
+
+        uint64_t GetTotal() const noexcept {
+            return _total.load(std::memory_order_relaxed);
+        }
+
+        uint64_t GetSum() const noexcept {
+            return _sum.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::span<const uint64_t> _bounds;
+        std::array<std::atomic<uint64_t>, MAX_BOUNDS + 1> _counts {};
+        std::atomic<uint64_t> _total = 0;
+        std::atomic<uint64_t> _sum = 0;
+    };
+
+    /// @brief Маршруты API, по которым собирается статистика strand
+    inline constexpr std::array<std::string_view, 10> API_ROUTES {
+        "/api/v1/maps",
+        "/api/v1/maps/{id}",
+        "/api/v1/game/join",
+        "/api/v1/game/players",
+        "/api/v1/game/state",
+        "/api/v1/game/player/action",
+        "/api/v1/game/player/actions",
+        "/api/v1/game/tick",
+        "/api/v1/metrics",
+        "other"
+    };
+
+    /// @brief Индекс маршрута в API_ROUTES для цели запроса
+    size_t GetRouteIndex(std::string_view target) noexcept;
+
+    /// @brief Статистика очереди apiStrand: глубина очереди при постановке запроса,
+    /// время ожидания в очереди и время выполнения по каждому маршруту (в микросекундах).
+    class StrandMetrics {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct RouteMetrics {
+            Histogram wait;
+            Histogram execution;
+        };
+
+        StrandMetrics();
+
+        StrandMetrics(const StrandMetrics&) = delete;
+        StrandMetrics& operator=(const StrandMetrics&) = delete;
+
+        /// @brief Запрос поставлен в очередь strand, перед ним в очереди depth запросов
+        void OnEnqueued(size_t depth) noexcept {
+            _depthHistogram.Record(depth);
+        }
+
+        /// @brief Запрос маршрута route провел в очереди wait и выполнялся execution
+        void OnCompleted(size_t route, Clock::duration wait, Clock::duration execution) noexcept;
+
+        const Histogram& GetDepthHistogram() const noexcept {
+            return _depthHistogram;
+        }
+
+        const RouteMetrics& GetRoute(size_t route) const noexcept {
+            return _routes[route];
+        }
+
+    private:
+        Histogram _depthHistogram;
+        std::array<RouteMetrics, API_ROUTES.size()> _routes;
+    };
+}
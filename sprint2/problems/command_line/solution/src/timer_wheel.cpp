@@ -0,0 +1,169 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace app {
+
+    TimerWheel::TimerWheel(uint64_t now) : _now {now} {};
+
+    TimerWheel::TimerId TimerWheel::Schedule(Key key, uint64_t deadline){
+        const TimerId timerId = _timers.PeekNextId();
+
+        auto& timer = _timers.Emplace(Timer{key, deadline, 0, 0, 0});
+
+        // просроченный таймер сработает при ближайшем продвижении времени
+        Link(timerId, timer, _now + 1);
+
+        return timerId;
+    }
+
+    bool TimerWheel::Reschedule(TimerId timerId, uint64_t deadline){
+        auto timer = _timers.Find(timerId);
+
+        if (!timer){
+            return false;
+        }
+
+        Unlink(*timer);
+
+        timer->deadline = deadline;
+
+        Link(timerId, *timer, _now + 1);
+
+        return true;
+    }
+
+    bool TimerWheel::Cancel(TimerId timerId){
+        auto timer = _timers.Find(timerId);
+
+        if (!timer){
+            return false;
+        }
+
+        Unlink(*timer);
+
+        return _timers.Erase(timerId);
+    }
+
+    std::vector<TimerWheel::Key> TimerWheel::Advance(uint64_t now){
+        std::vector<Key> fired;
+
+        while (_now < now){
+            if (_timers.empty()){
+                _now = now;
+
+                break;
+            }
+
+            // нижний уровень пуст - до ближайшей точки, где опускается непустой уровень, ничего не сработает
+            if (_levelSizes[0] == 0){
+                unsigned level = 1;
+
+                while (_levelSizes[level] == 0){
+                    ++level;
+                }
+
+                const uint64_t period = uint64_t{1} << (SLOT_BITS * level);
+                const uint64_t boundary = (_now / period + 1) * period;
+
+                if (boundary > now){
+                    _now = now;
+
+                    break;
+                }
+
+                _now = boundary - 1;
+            }
+
+            ++_now;
+
+            // начало нового круга уровня - опускаем его ячейку на уровень ниже
+            for (unsigned level = 1; level < LEVELS && (_now & ((uint64_t{1} << (SLOT_BITS * level)) - 1)) == 0; ++level){
+                Cascade(level);
+            }
+
+            for (TimerId timerId : TakeBucket(static_cast<uint32_t>(_now & SLOT_MASK))){
+                auto& timer = *_timers.Find(timerId);
+
+                if (timer.deadline > _now){
+                    // таймер дальше горизонта колеса - ставим заново
+                    Link(timerId, timer, _now + 1);
+
+                    continue;
+                }
+
+                fired.push_back(timer.key);
+
+                _timers.Erase(timerId);
+            }
+        }
+
+        return fired;
+    }
+
+    void TimerWheel::Link(TimerId timerId, Timer& timer, uint64_t earliest){
+        const uint64_t deadline = std::clamp(timer.deadline, earliest, _now + MAX_DELTA);
+        const uint64_t delta = deadline - _now;
+
+        unsigned level = 0;
+
+        while (level + 1 < LEVELS && delta >= (uint64_t{1} << (SLOT_BITS * (level + 1)))){
+            ++level;
+        }
+
+        timer.bucket = static_cast<uint32_t>(level * SLOTS + ((deadline >> (SLOT_BITS * level)) & SLOT_MASK));
+        timer.prev = 0;
+        timer.next = _buckets[timer.bucket];
+
+        if (timer.next){
+            _timers.Find(timer.next)->prev = timerId;
+        }
+
+        _buckets[timer.bucket] = timerId;
+
+        ++_levelSizes[level];
+    }
+
+    void TimerWheel::Unlink(Timer& timer){
+        if (timer.prev){
+            _timers.Find(timer.prev)->next = timer.next;
+        } else {
+            _buckets[timer.bucket] = timer.next;
+        }
+
+        if (timer.next){
+            _timers.Find(timer.next)->prev = timer.prev;
+        }
+
+        --_levelSizes[timer.bucket / SLOTS];
+    }
+
+    std::vector<TimerWheel::TimerId> TimerWheel::TakeBucket(uint32_t bucket){
+        std::vector<TimerId> result;
+
+        for (TimerId timerId = _buckets[bucket]; timerId;){
+            auto& timer = *_timers.Find(timerId);
+
+            result.push_back(timerId);
+
+            timerId = timer.next;
+        }
+
+        _buckets[bucket] = 0;
+        _levelSizes[bucket / SLOTS] -= result.size();
+
+        // порядок срабатывания внутри ячейки - по срокам
+        std::ranges::sort(result, {}, [this](TimerId timerId){ return _timers.Find(timerId)->deadline; });
+
+        return result;
+    }
+
+    void TimerWheel::Cascade(unsigned level){
+        const auto slot = (_now >> (SLOT_BITS * level)) & SLOT_MASK;
+
+        for (TimerId timerId : TakeBucket(static_cast<uint32_t>(level * SLOTS + slot))){
+            // срок может совпадать с текущим моментом: нижняя ячейка для него еще не обработана
+            Link(timerId, *_timers.Find(timerId), _now);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "slot_map.h"
+
+namespace app {
+
+    /// @brief Иерархическое колесо таймеров на игровом времени (миллисекунды).
+    /// Постановка, перенос и отмена таймера - O(1): таймер лежит в двусвязном списке
+    /// ячейки колеса. Срок до 64 мс хранится в нижнем уровне с точностью до миллисекунды,
+    /// более далекие - в верхних уровнях, откуда таймеры опускаются вниз по мере
+    /// приближения срока. Продвижение времени пропускает пустые участки колеса,
+    /// поэтому его стоимость зависит от числа таймеров, а не от длительности тика.
+    class TimerWheel {
+    public:
+        using TimerId = util::SlotId;
+        using Key = uint64_t;
+
+        explicit TimerWheel(uint64_t now = 0);
+
+        /// @brief Поставить таймер с ключом key на момент deadline
+        TimerId Schedule(Key key, uint64_t deadline);
+
+        /// @brief Перенести таймер на новый срок. false, если таймер уже сработал или отменен
+        bool Reschedule(TimerId timerId, uint64_t deadline);
+
+        bool Cancel(TimerId timerId);
+
+        /// @brief Продвинуть время до now.
+        /// @return ключи сработавших таймеров (срок <= now) в порядке их сроков
+        std::vector<Key> Advance(uint64_t now);
+
+        uint64_t GetNow() const noexcept {
+            return _now;
+        }
+
+        size_t size() const noexcept {
+            return _timers.size();
+        }
+
+    private:
+        static constexpr unsigned SLOT_BITS = 6;
+        static constexpr uint64_t SLOTS = 1 << SLOT_BITS;
+        static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+        static constexpr unsigned LEVELS = 4;
+        // самый далекий срок, который помещается в колесо; более поздние таймеры
+        // кладутся на этот срок и при срабатывании переставляются заново
+        static constexpr uint64_t MAX_DELTA = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+
+        struct Timer {
+            Key key;
+            uint64_t deadline;
+            TimerId prev;
+            TimerId next;
+            uint32_t bucket;
+        };
+
+        uint64_t _now;
+        util::SlotMap<Timer> _timers;
+        // первый таймер каждой ячейки, 0 - ячейка пуста
+        std::array<TimerId, SLOTS * LEVELS> _buckets {};
+        // число таймеров на каждом уровне
+        std::array<size_t, LEVELS> _levelSizes {};
+
+        /// @brief Положить таймер в ячейку его срока, но не раньше earliest
+        void Link(TimerId timerId, Timer& timer, uint64_t earliest);
+
+        void Unlink(Timer& timer);
+
+        /// @brief Забрать все таймеры ячейки
+        std::vector<TimerId> TakeBucket(uint32_t bucket);
+
+        /// @brief Опустить таймеры ячейки уровня level, соответствующей текущему времени
+        void Cascade(unsigned level);
+    };
+}
@@ -0,0 +1,46 @@
+#include "token_generator.h"
+
+#include <cstdint>
+#include <random>
+
+namespace tokens {
+
+namespace {
+
+struct Generators {
+    std::mt19937_64 generator1;
+    std::mt19937_64 generator2;
+
+    Generators() {
+        std::random_device random_device;
+        std::uniform_int_distribution<std::mt19937_64::result_type> dist;
+
+        generator1.seed(dist(random_device));
+        generator2.seed(dist(random_device));
+    }
+};
+
+// то же, что "%016x": 16 символов в нижнем регистре с ведущими нулями
+void WriteHex(uint64_t value, char* out) {
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    for (int i = 15; i >= 0; --i) {
+        out[i] = HEX[value & 0x0F];
+        value >>= 4;
+    }
+}
+
+}  // namespace
+
+Token TokenGenerator::Generate() {
+    thread_local Generators generators;
+
+    Token token;
+
+    WriteHex(generators.generator1(), token.data());
+    WriteHex(generators.generator2(), token.data() + 16);
+
+    return token;
+}
+
+}  // namespace tokens
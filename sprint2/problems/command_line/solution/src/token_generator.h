@@ -1,38 +1,22 @@
 #pragma once
 
-#include <random>
-#include <sstream>
-#include <boost/format.hpp>
+#include <array>
+#include <string>
 
 namespace tokens {
-    class token_generator
-    {
-    private:
-        std::random_device _random_device;
-        
-        std::mt19937_64 _generator1 {[this] {
-            std::uniform_int_distribution<std::mt19937_64::result_type> dist;
-            return dist(_random_device);
-        }()};
+    // 32 шестнадцатеричных символа
+    using Token = std::array<char, 32>;
 
-        std::mt19937_64 _generator2 {[this]{
-            std::uniform_int_distribution<std::mt19937_64::result_type> dist;
-            return dist(_random_device);
-        }()};
-
-        /* data */
+    /// @brief Генерация токенов авторизации. Потокобезопасна: у каждого потока
+    /// свои генераторы, которые засеиваются из std::random_device один раз.
+    class TokenGenerator {
     public:
-        std::string create();
-    };
-    
-    std::string token_generator::create(){
-        auto value1 = _generator1();
-        auto value2 = _generator2();
+        static Token Generate();
 
-        std::ostringstream str;
+        static std::string GenerateString() {
+            auto token = Generate();
 
-        str << boost::format("%016x%016x") % value1 % value2;
-
-        return str.str();
-    }
-}
\ No newline at end of file
+            return std::string(token.begin(), token.end());
+        }
+    };
+}
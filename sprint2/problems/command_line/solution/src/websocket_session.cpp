@@ -0,0 +1,118 @@
+#include "websocket_session.h"
+#include "http_server.h"
+
+#include <boost/asio/post.hpp>
+
+namespace http_server {
+
+    void WebSocketSession::Send(Frame frame)
+    {
+        if (!open_)
+        {
+            return;
+        }
+
+        net::post(ws_.get_executor(),
+                  [self = shared_from_this(), frame = std::move(frame)]() mutable {
+                      self->Enqueue(std::move(frame));
+                  });
+    }
+
+    void WebSocketSession::Close()
+    {
+        net::post(ws_.get_executor(), [self = shared_from_this()] {
+            if (!self->open_.exchange(false))
+            {
+                return;
+            }
+
+            self->ws_.async_close(websocket::close_code::normal, [self](beast::error_code) {});
+        });
+    }
+
+    void WebSocketSession::Read()
+    {
+        // входящие сообщения не используются, чтение нужно для обработки ping/close
+        ws_.async_read(buffer_, beast::bind_front_handler(&WebSocketSession::OnRead, shared_from_this()));
+    }
+
+    void WebSocketSession::OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read)
+    {
+        if (ec)
+        {
+            return OnError(ec, "ws_read"sv);
+        }
+
+        buffer_.consume(buffer_.size());
+
+        Read();
+    }
+
+    void WebSocketSession::Enqueue(Frame frame)
+    {
+        if (!open_)
+        {
+            return;
+        }
+
+        // первый кадр может уже записываться в сокет - его не трогаем
+        const size_t pending_from = writing_ ? 1 : 0;
+
+        if (queue_.size() >= MAX_QUEUE_SIZE + pending_from)
+        {
+            queue_.erase(queue_.begin() + pending_from);
+            ++dropped_frames_;
+        }
+
+        queue_.emplace_back(std::move(frame));
+
+        if (!writing_)
+        {
+            Write();
+        }
+    }
+
+    void WebSocketSession::Write()
+    {
+        writing_ = true;
+
+        ws_.text(true);
+        ws_.async_write(net::buffer(*queue_.front()),
+                        beast::bind_front_handler(&WebSocketSession::OnWrite, shared_from_this()));
+    }
+
+    void WebSocketSession::OnWrite(beast::error_code ec, [[maybe_unused]] std::size_t bytes_written)
+    {
+        writing_ = false;
+
+        if (ec)
+        {
+            return OnError(ec, "ws_write"sv);
+        }
+
+        queue_.pop_front();
+
+        if (!queue_.empty() && open_)
+        {
+            Write();
+        }
+    }
+
+    void WebSocketSession::OnError(beast::error_code ec, std::string_view where)
+    {
+        open_ = false;
+
+        // буфер текущей записи должен жить до её завершения
+        if (!writing_)
+        {
+            queue_.clear();
+        }
+
+        if (ec == websocket::error::closed || ec == net::error::operation_aborted)
+        {
+            return;
+        }
+
+        ReportError(ec, where);
+    }
+}  // namespace http_server
@@ -0,0 +1,102 @@
+#pragma once
+#include "sdk.h"
+//
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace http_server {
+
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+
+/// @brief WebSocket-соединение, в которое сервер отправляет текстовые кадры.
+/// Кадры разделяются между подписчиками (shared_ptr на один буфер),
+/// у каждого соединения своя очередь отправки ограниченной длины.
+class WebSocketSession : public std::enable_shared_from_this<WebSocketSession> {
+public:
+    using HttpRequest = http::request<http::string_body>;
+    using Frame = std::shared_ptr<const std::string>;
+
+    // максимальное число кадров, ожидающих отправки; при переполнении
+    // самые старые неотправленные кадры отбрасываются (медленный клиент)
+    static constexpr size_t MAX_QUEUE_SIZE = 4;
+
+    explicit WebSocketSession(tcp::socket&& socket) : ws_(std::move(socket)) {}
+
+    WebSocketSession(const WebSocketSession&) = delete;
+    WebSocketSession& operator=(const WebSocketSession&) = delete;
+
+    /// @brief Завершить handshake по исходному http-запросу и вызвать handler(self, request)
+    template <typename Handler>
+    void Accept(HttpRequest&& request, Handler&& handler) {
+        auto safe_request = std::make_shared<HttpRequest>(std::move(request));
+
+        // у websocket::stream свои таймауты: handshake, простой и ping, на который
+        // клиент обязан ответить. Клиент, который перестал читать, не отвечает на ping
+        // и отключается, не удерживая сокет и очередь кадров
+        beast::get_lowest_layer(ws_).expires_never();
+
+        auto timeout = websocket::stream_base::timeout::suggested(beast::role_type::server);
+        timeout.keep_alive_pings = true;
+        ws_.set_option(timeout);
+
+        ws_.async_accept(*safe_request,
+            [self = shared_from_this(), safe_request, handler = std::forward<Handler>(handler)](beast::error_code ec) mutable {
+                if (ec) {
+                    self->OnError(ec, "ws_accept");
+                    return;
+                }
+
+                self->Read();
+
+                handler(self, *safe_request);
+            });
+    }
+
+    /// @brief Поставить кадр в очередь отправки. Потокобезопасен.
+    void Send(Frame frame);
+
+    /// @brief Закрыть соединение. Потокобезопасен.
+    void Close();
+
+    /// @brief false после закрытия соединения или ошибки
+    bool IsOpen() const noexcept {
+        return open_;
+    }
+
+    /// @brief Количество кадров, отброшенных из-за медленного клиента
+    size_t GetDroppedFrames() const noexcept {
+        return dropped_frames_;
+    }
+
+private:
+    websocket::stream<beast::tcp_stream> ws_;
+    beast::flat_buffer buffer_;
+    std::deque<Frame> queue_;
+    bool writing_ = false;
+    std::atomic_bool open_ = true;
+    std::atomic_size_t dropped_frames_ = 0;
+
+    void Read();
+
+    void OnRead(beast::error_code ec, std::size_t bytes_read);
+
+    void Enqueue(Frame frame);
+
+    void Write();
+
+    void OnWrite(beast::error_code ec, std::size_t bytes_written);
+
+    void OnError(beast::error_code ec, std::string_view where);
+};
+
+}  // namespace http_server
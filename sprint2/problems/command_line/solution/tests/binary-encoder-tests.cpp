@@ -0,0 +1,264 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "../src/binary_encoder.h"
+#include "../src/json_writer.h"
+
+using namespace std::literals;
+
+namespace {
+
+model::Map MakeMap() {
+    model::Map map {model::Map::Id{"town"s}, "Town \"quoted\" и юникод"s};
+
+    map.AddRoad({model::Road::HORIZONTAL, {0, 0}, 40});
+    map.AddRoad({model::Road::VERTICAL, {40, 0}, 30});
+    map.AddRoad({model::Road::HORIZONTAL, {40, 30}, -7});
+    map.AddRoad({model::Road::VERTICAL, {-3, 8}, 8});
+    map.AddBuilding(model::Building{{{5, 5}, {30, 20}}});
+    map.AddBuilding(model::Building{{{-10, -20}, {3, 4}}});
+    map.AddOffice({model::Office::Id{"o0"s}, {40, 30}, {5, 0}});
+    map.AddOffice({model::Office::Id{"o1"s}, {-1, 2}, {-5, 3}});
+
+    return map;
+}
+
+std::shared_ptr<const model::Map> MakeSessionMap() {
+    return std::make_shared<const model::Map>(model::Map::Id{"map1"s}, "Map 1"s);
+}
+
+binary::GameState Decode(const std::string& data) {
+    binary::Reader reader {data};
+
+    auto state = binary::DecodeGameState(reader);
+
+    REQUIRE(reader.AtEnd());
+
+    return state;
+}
+
+// равенство с учетом знака нуля и NaN: двоичный формат передает double без потерь
+bool SameBits(double lhs, double rhs) {
+    return std::bit_cast<uint64_t>(lhs) == std::bit_cast<uint64_t>(rhs);
+}
+
+void CheckDog(const binary::DogState& decoded, const model::Dog& dog, char direction) {
+    CHECK(decoded.playerId == dog.playerId);
+    CHECK(SameBits(decoded.coord.x, dog.coord.x));
+    CHECK(SameBits(decoded.coord.y, dog.coord.y));
+    CHECK(SameBits(decoded.speed.vx, dog.speed.vx));
+    CHECK(SameBits(decoded.speed.vy, dog.speed.vy));
+    CHECK(decoded.direction == direction);
+}
+
+}  // namespace
+
+SCENARIO("Binary values are little-endian") {
+    std::string out;
+    binary::Writer writer {out};
+
+    GIVEN("numbers and a string") {
+        writer.U8(0xAB);
+        writer.U16(0x0102);
+        writer.U32(0x01020304);
+        writer.I32(-2);
+        writer.U64(0x0102030405060708);
+        writer.F64(1.0);
+        writer.String("ab"sv);
+
+        THEN("the least significant byte goes first") {
+            CHECK(out == "\xAB"
+                         "\x02\x01"
+                         "\x04\x03\x02\x01"
+                         "\xFE\xFF\xFF\xFF"
+                         "\x08\x07\x06\x05\x04\x03\x02\x01"
+                         "\x00\x00\x00\x00\x00\x00\xF0\x3F"
+                         "\x02\x00" "ab"s);
+        }
+
+        THEN("the reader gets the same values back") {
+            binary::Reader reader {out};
+
+            CHECK(reader.U8() == 0xAB);
+            CHECK(reader.U16() == 0x0102);
+            CHECK(reader.U32() == 0x01020304);
+            CHECK(reader.I32() == -2);
+            CHECK(reader.U64() == 0x0102030405060708);
+            CHECK(reader.F64() == 1.0);
+            CHECK(reader.String() == "ab"sv);
+            CHECK(reader.AtEnd());
+        }
+
+        THEN("truncated data is rejected") {
+            binary::Reader reader {std::string_view {out}.substr(0, 2)};
+
+            reader.U8();
+            CHECK_THROWS_AS(reader.U16(), std::runtime_error);
+        }
+    }
+}
+
+SCENARIO("Binary game state round trip") {
+    model::GameSession session {1, MakeSessionMap()};
+
+    GIVEN("an empty session") {
+        std::string out;
+        binary::EncodeGameState(out, session, std::nullopt);
+
+        THEN("only the header is written") {
+            CHECK(out.size() == sizeof(uint64_t) + sizeof(uint8_t) + sizeof(uint32_t));
+
+            const auto state = Decode(out);
+
+            CHECK(state.version == 0);
+            CHECK(state.full);
+            CHECK(state.dogs.empty());
+        }
+    }
+
+    GIVEN("dogs with every direction and edge-case coordinates") {
+        const std::vector<double> values {
+            0.0, -0.0, 1.0 / 3.0, -2.5, 1e-300, std::numeric_limits<double>::max(), std::nextafter(10.0, 11.0)
+        };
+        const char directions[] = {'U', 'D', 'L', 'R'};
+
+        std::vector<model::DogId> ids;
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            auto& dog = session.AddDog(100 + i, {values[i], values[values.size() - 1 - i]}, 0);
+
+            dog.speed = {-values[i], values[i]};
+            dog.direction = static_cast<model::Direction>(i % 4);
+            session.MarkChanged(dog);
+
+            ids.push_back(dog.id);
+        }
+
+        THEN("a full snapshot decodes to the same dogs") {
+            std::string out;
+            binary::EncodeGameState(out, session, std::nullopt);
+
+            const auto state = Decode(out);
+
+            CHECK(state.version == session.GetVersion());
+            CHECK(state.full);
+            REQUIRE(state.dogs.size() == ids.size());
+
+            for (size_t i = 0; i < ids.size(); ++i) {
+                CheckDog(state.dogs[i], *session.GetDog(ids[i]), directions[i % 4]);
+            }
+        }
+
+        THEN("a delta carries only the dogs changed after since") {
+            const auto since = session.GetVersion();
+
+            auto& moved = *session.GetDog(ids[2]);
+            moved.coord = {7.0, 8.0};
+            session.MarkChanged(moved);
+
+            std::string out;
+            binary::EncodeGameState(out, session, since);
+
+            const auto state = Decode(out);
+
+            CHECK_FALSE(state.full);
+            CHECK(state.version == since + 1);
+            REQUIRE(state.dogs.size() == 1);
+            CheckDog(state.dogs[0], moved, directions[2]);
+        }
+    }
+}
+
+SCENARIO("Binary map round trip") {
+    GIVEN("a map with roads, buildings and offices") {
+        const auto map = MakeMap();
+
+        std::string out;
+        binary::EncodeMap(out, map);
+
+        binary::Reader reader {out};
+        const auto decoded = binary::DecodeMap(reader);
+
+        THEN("all of them decode unchanged") {
+            CHECK(reader.AtEnd());
+            CHECK(*decoded.GetId() == *map.GetId());
+            CHECK(decoded.GetName() == map.GetName());
+
+            REQUIRE(decoded.GetRoads().size() == map.GetRoads().size());
+
+            for (size_t i = 0; i < map.GetRoads().size(); ++i) {
+                CHECK(decoded.GetRoads()[i].IsHorizontal() == map.GetRoads()[i].IsHorizontal());
+                CHECK(decoded.GetRoads()[i].GetStart().x == map.GetRoads()[i].GetStart().x);
+                CHECK(decoded.GetRoads()[i].GetStart().y == map.GetRoads()[i].GetStart().y);
+                CHECK(decoded.GetRoads()[i].GetEnd().x == map.GetRoads()[i].GetEnd().x);
+                CHECK(decoded.GetRoads()[i].GetEnd().y == map.GetRoads()[i].GetEnd().y);
+            }
+
+            REQUIRE(decoded.GetBuildings().size() == map.GetBuildings().size());
+
+            for (size_t i = 0; i < map.GetBuildings().size(); ++i) {
+                const auto& lhs = decoded.GetBuildings()[i].GetBounds();
+                const auto& rhs = map.GetBuildings()[i].GetBounds();
+
+                CHECK(lhs.position.x == rhs.position.x);
+                CHECK(lhs.position.y == rhs.position.y);
+                CHECK(lhs.size.width == rhs.size.width);
+                CHECK(lhs.size.height == rhs.size.height);
+            }
+
+            REQUIRE(decoded.GetOffices().size() == map.GetOffices().size());
+
+            for (size_t i = 0; i < map.GetOffices().size(); ++i) {
+                CHECK(*decoded.GetOffices()[i].GetId() == *map.GetOffices()[i].GetId());
+                CHECK(decoded.GetOffices()[i].GetPosition().x == map.GetOffices()[i].GetPosition().x);
+                CHECK(decoded.GetOffices()[i].GetPosition().y == map.GetOffices()[i].GetPosition().y);
+                CHECK(decoded.GetOffices()[i].GetOffset().dx == map.GetOffices()[i].GetOffset().dx);
+                CHECK(decoded.GetOffices()[i].GetOffset().dy == map.GetOffices()[i].GetOffset().dy);
+            }
+        }
+
+        THEN("encoding the decoded map gives the same bytes") {
+            std::string again;
+            binary::EncodeMap(again, decoded);
+
+            CHECK(again == out);
+        }
+    }
+}
+
+// запуск: game_server_tests "[benchmark]"
+TEST_CASE("Game state encoding: binary vs JSON", "[.][benchmark]") {
+    model::GameSession session {1, MakeSessionMap()};
+
+    for (size_t i = 0; i < 10'000; ++i) {
+        auto& dog = session.AddDog(i, {i * 0.37, i * 1.13}, 0);
+
+        dog.speed = {(i % 3) * 1.5, -(i % 5) * 0.25};
+        dog.direction = static_cast<model::Direction>(i % 4);
+    }
+
+    std::string binaryState;
+    binary::EncodeGameState(binaryState, session, std::nullopt);
+
+    std::string jsonState;
+    json_writer::WriteGameState(jsonState, session);
+
+    // размеры одного и того же состояния из 10000 собак
+    WARN("binary: "s + std::to_string(binaryState.size()) + " bytes, JSON: "s + std::to_string(jsonState.size()) + " bytes"s);
+    CHECK(binaryState.size() < jsonState.size());
+
+    BENCHMARK("binary game state") {
+        std::string out;
+        binary::EncodeGameState(out, session, std::nullopt);
+        return out;
+    };
+
+    BENCHMARK("JSON game state") {
+        std::string out;
+        json_writer::WriteGameState(out, session);
+        return out;
+    };
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include "../src/config_parser.h"
+#include "../src/road_graph.h"
+
+using namespace std::literals;
+
+namespace {
+    model::Game Parse(const std::string& config) {
+        std::istringstream input {config};
+
+        return json_loader::ParseGame(input);
+    }
+
+    /// @brief Строка ошибки разбора config, 0 - ошибки нет
+    size_t ErrorLine(const std::string& config) {
+        try {
+            Parse(config);
+        } catch (const json_loader::ConfigError& e) {
+            CHECK(e.GetColumn() > 0);
+            return e.GetLine();
+        }
+
+        return 0;
+    }
+}
+
+SCENARIO("Streaming config parser") {
+    GIVEN("a valid config") {
+        const auto config = R"({
+            "defaultDogSpeed": 3.0,
+            "dogRetirementTime": 15.5,
+            "defaultSessionCapacity": 4,
+            "lootGeneratorConfig": {"period": 5.0, "probability": [0.5]},
+            "maps": [
+                {
+                    "id": "map1",
+                    "name": "Map 1",
+                    "dogSpeed": 4,
+                    "roads": [{"x0": 0, "y0": 0, "x1": 40}, {"x0": 40, "y0": 0, "y1": 30}],
+                    "buildings": [{"x": 5, "y": 5, "w": 30, "h": 20}],
+                    "offices": [{"id": "o0", "x": 40, "y": 30, "offsetX": 5, "offsetY": 0}],
+                    "lootTypes": [{"name": "key", "file": "assets/key.obj"}]
+                },
+                {"id": "map2", "name": "Map 2", "sessionCapacity": 2, "roads": [], "buildings": [], "offices": []}
+            ]
+        })"s;
+
+        const auto game = Parse(config);
+
+        THEN("game settings are read") {
+            CHECK(game.GetDefaultDogSpeed() == 3.0);
+            CHECK(game.GetDogRetirementTime() == 15500);
+            CHECK(game.GetDefaultSessionCapacity() == 4);
+        }
+
+        THEN("maps are built with their roads, buildings, offices and road graphs") {
+            REQUIRE(game.GetMaps().size() == 2);
+
+            const auto& map = game.GetMaps()[0];
+            CHECK(*map.GetId() == "map1"s);
+            CHECK(map.GetName() == "Map 1"s);
+            CHECK(map.GetDogSpeed() == 4.0);
+            REQUIRE(map.GetRoads().size() == 2);
+            CHECK(map.GetRoads()[0].IsHorizontal());
+            CHECK(map.GetRoads()[1].IsVertical());
+            CHECK(map.GetRoads()[1].GetEnd().y == 30);
+            REQUIRE(map.GetBuildings().size() == 1);
+            CHECK(map.GetBuildings()[0].GetBounds().size.height == 20);
+            REQUIRE(map.GetOffices().size() == 1);
+            CHECK(*map.GetOffices()[0].GetId() == "o0"s);
+            CHECK(map.GetRoadGraph().GetRoads().size() == 2);
+
+            CHECK(game.GetMaps()[1].GetSessionCapacity() == 2);
+        }
+    }
+
+    GIVEN("a config larger than one read block") {
+        const auto config = "{\"maps\": ["s + std::string(200'000, ' ')
+            + R"({"id": "m", "name": "M", "roads": [], "buildings": [], "offices": []}]})"s + std::string(100'000, '\n');
+
+        THEN("it is parsed block by block") {
+            CHECK(Parse(config).GetMaps().size() == 1);
+        }
+    }
+
+    GIVEN("an invalid config") {
+        THEN("a missing road end is reported on the line of the road") {
+            CHECK(ErrorLine("{\"maps\": [{\"id\": \"m\", \"name\": \"M\",\n\"roads\": [{\"x0\": 0, \"y0\": 0}]}]}"s) == 2);
+        }
+
+        THEN("a field of the wrong type is reported on the line of its value") {
+            CHECK(ErrorLine("{\n  \"maps\": [\n    {\"id\": 5}]}"s) == 3);
+            CHECK(ErrorLine("{\"defaultSessionCapacity\": 0.5}"s) == 1);
+        }
+
+        THEN("a map without required fields is rejected") {
+            CHECK_THROWS_AS(Parse(R"({"maps": [{"id": "m", "name": "M", "roads": [], "buildings": []}]})"s), json_loader::ConfigError);
+        }
+
+        THEN("invalid values are rejected") {
+            CHECK_THROWS_AS(Parse(R"({"dogRetirementTime": -1})"s), json_loader::ConfigError);
+            CHECK_THROWS_AS(Parse(R"({"maps": [5]})"s), json_loader::ConfigError);
+            CHECK_THROWS_AS(Parse(R"([])"s), json_loader::ConfigError);
+        }
+
+        THEN("broken JSON is rejected") {
+            CHECK_THROWS_AS(Parse(R"({"maps": [)"s), json_loader::ConfigError);
+            CHECK_THROWS_AS(Parse(R"({"maps": []} x)"s), json_loader::ConfigError);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "../src/fast_random.h"
+#include "../src/model.h"
+
+namespace {
+
+std::vector<uint64_t> Take(util::FastRandom& random, size_t count) {
+    std::vector<uint64_t> result(count);
+    std::generate(result.begin(), result.end(), [&random] {
+        return random();
+    });
+    return result;
+}
+
+}  // namespace
+
+SCENARIO("Fast random generator") {
+    GIVEN("two generators with the same seed") {
+        util::FastRandom first{42};
+        util::FastRandom second{42};
+
+        THEN("they produce the same sequence") {
+            CHECK(Take(first, 100) == Take(second, 100));
+        }
+
+        WHEN("one of them is reseeded with another seed") {
+            second.Seed(43);
+
+            THEN("the sequences differ") {
+                CHECK(Take(first, 100) != Take(second, 100));
+            }
+        }
+    }
+
+    GIVEN("a generator") {
+        util::FastRandom random{7};
+
+        THEN("bounded numbers stay in range and cover it") {
+            std::vector<int> hits(10);
+
+            for (int i = 0; i < 10000; ++i) {
+                const auto value = random.NextBelow(hits.size());
+                REQUIRE(value < hits.size());
+                ++hits[value];
+            }
+
+            CHECK(std::ranges::all_of(hits, [](int count) {
+                return count > 800 && count < 1200;
+            }));
+        }
+
+        THEN("doubles are in [0, 1)") {
+            for (int i = 0; i < 10000; ++i) {
+                const double value = random.NextDouble();
+                REQUIRE(value >= 0);
+                REQUIRE(value < 1);
+            }
+        }
+    }
+
+    GIVEN("two games with the same seed") {
+        auto makeGame = [](uint64_t seed) {
+            model::Game game;
+            game.AddMap(model::Map{model::Map::Id{"map1"}, "Map 1"});
+            game.SetRandomSeed(seed);
+            return game;
+        };
+
+        model::Game first = makeGame(1);
+        model::Game second = makeGame(1);
+        model::Game other = makeGame(2);
+
+        const model::Map::Id mapId{"map1"};
+
+        // ссылки на сессии живут только до создания следующей сессии
+        auto draw = [&mapId](model::Game& game) {
+            return Take(game.CreateSession(mapId).GetRandom(), 10);
+        };
+
+        THEN("their sessions draw the same numbers") {
+            const auto numbers = draw(first);
+
+            CHECK(numbers == draw(second));
+            CHECK(numbers != draw(other));
+
+            AND_THEN("different sessions of one game draw different numbers") {
+                CHECK(draw(first) != numbers);
+            }
+        }
+    }
+}
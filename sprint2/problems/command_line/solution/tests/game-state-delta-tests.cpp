@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <boost/json.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <optional>
+
+#include "../src/json_writer.h"
+#include "../src/model.h"
+
+using namespace std::literals;
+namespace json = boost::json;
+
+namespace {
+
+std::shared_ptr<const model::Map> MakeMap() {
+    return std::make_shared<const model::Map>(model::Map::Id{"map1"s}, "Map 1"s);
+}
+
+json::object WriteState(model::GameSession& session, std::optional<uint64_t> since) {
+    std::string out;
+    json_writer::WriteVersionedGameState(out, session, since);
+
+    return json::parse(out).as_object();
+}
+
+// id игроков в ответе
+std::vector<std::string> GetPlayers(const json::object& state) {
+    std::vector<std::string> players;
+
+    for (const auto& [id, dog] : state.at("players"s).as_object()) {
+        players.emplace_back(id);
+    }
+
+    std::sort(players.begin(), players.end());
+
+    return players;
+}
+
+}  // namespace
+
+SCENARIO("Game session versions") {
+    model::GameSession session {1, MakeMap()};
+
+    GIVEN("a new session") {
+        THEN("it starts at version 0 and can send a delta from it") {
+            CHECK(session.GetVersion() == 0);
+            CHECK(session.CanDeltaFrom(0));
+            CHECK_FALSE(session.CanDeltaFrom(1));
+        }
+    }
+
+    GIVEN("dogs that were added and changed") {
+        // ссылки на собак не переживают добавление следующих, поэтому храним id
+        const auto first = session.AddDog(1, {0, 0}, 0).id;
+        const auto second = session.AddDog(2, {1, 0}, 0).id;
+
+        THEN("every change takes the next session version") {
+            CHECK(session.GetDog(first)->version == 1);
+            CHECK(session.GetDog(second)->version == 2);
+            CHECK(session.GetVersion() == 2);
+
+            auto& dog = *session.GetDog(first);
+            dog.coord = {5, 0};
+            session.MarkChanged(dog);
+
+            CHECK(dog.version == 3);
+            CHECK(session.GetVersion() == 3);
+        }
+
+        WHEN("a dog is removed") {
+            const auto beforeRemoval = session.GetVersion();
+
+            REQUIRE(session.RemoveDog(second));
+
+            THEN("the version advances and older deltas are no longer possible") {
+                CHECK(session.GetVersion() == beforeRemoval + 1);
+                CHECK_FALSE(session.CanDeltaFrom(beforeRemoval));
+                CHECK(session.CanDeltaFrom(session.GetVersion()));
+            }
+        }
+    }
+}
+
+SCENARIO("Versioned game state") {
+    model::GameSession session {1, MakeMap()};
+
+    const auto first = session.AddDog(1, {0, 0}, 0).id;
+    const auto second = session.AddDog(2, {1, 0}, 0).id;
+    session.AddDog(3, {2, 0}, 0);
+
+    auto move = [&session](model::DogId id, model::Position coord) {
+        auto& dog = *session.GetDog(id);
+        dog.coord = coord;
+        session.MarkChanged(dog);
+    };
+
+    GIVEN("no since parameter") {
+        const auto state = WriteState(session, std::nullopt);
+
+        THEN("the full snapshot is returned") {
+            CHECK(state.at("full"s).as_bool());
+            CHECK(state.at("version"s).to_number<uint64_t>() == session.GetVersion());
+            CHECK(GetPlayers(state) == std::vector{"1"s, "2"s, "3"s});
+        }
+    }
+
+    GIVEN("a client at the current version") {
+        const auto since = session.GetVersion();
+
+        THEN("nothing has changed") {
+            const auto state = WriteState(session, since);
+
+            CHECK_FALSE(state.at("full"s).as_bool());
+            CHECK(state.at("players"s).as_object().empty());
+        }
+
+        WHEN("one dog moves") {
+            move(second, {1, 3});
+
+            THEN("only that dog is sent") {
+                const auto state = WriteState(session, since);
+
+                CHECK_FALSE(state.at("full"s).as_bool());
+                CHECK(state.at("version"s).to_number<uint64_t>() == since + 1);
+                CHECK(GetPlayers(state) == std::vector{"2"s});
+            }
+        }
+
+        WHEN("a dog is removed after since") {
+            REQUIRE(session.RemoveDog(first));
+
+            THEN("a full snapshot without the removed dog is sent") {
+                const auto state = WriteState(session, since);
+
+                CHECK(state.at("full"s).as_bool());
+                CHECK(GetPlayers(state) == std::vector{"2"s, "3"s});
+            }
+
+            AND_WHEN("the client catches up past the removal") {
+                const auto caughtUp = session.GetVersion();
+
+                move(second, {1, 4});
+
+                THEN("deltas resume") {
+                    const auto state = WriteState(session, caughtUp);
+
+                    CHECK_FALSE(state.at("full"s).as_bool());
+                    CHECK(GetPlayers(state) == std::vector{"2"s});
+                }
+            }
+        }
+    }
+
+    GIVEN("a version from the future, e.g. from before a server restart") {
+        const auto state = WriteState(session, session.GetVersion() + 10);
+
+        THEN("the full snapshot is returned") {
+            CHECK(state.at("full"s).as_bool());
+            CHECK(GetPlayers(state).size() == 3);
+        }
+    }
+}
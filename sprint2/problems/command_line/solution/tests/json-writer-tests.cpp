@@ -0,0 +1,142 @@
+#include <boost/json.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+
+#include "../src/json_loader.h"
+#include "../src/json_writer.h"
+
+using namespace std::literals;
+namespace json = boost::json;
+
+namespace {
+
+model::Map MakeMap(std::string id, std::string name) {
+    model::Map map {model::Map::Id{std::move(id)}, std::move(name)};
+
+    map.AddRoad({model::Road::HORIZONTAL, {0, 0}, 40});
+    map.AddRoad({model::Road::VERTICAL, {40, 0}, 30});
+    map.AddRoad({model::Road::HORIZONTAL, {40, 30}, -7});
+    map.AddBuilding(model::Building{{{5, 5}, {30, 20}}});
+    map.AddOffice({model::Office::Id{"o0"s}, {40, 30}, {5, 0}});
+    map.AddOffice({model::Office::Id{"o\"1"s}, {-1, 2}, {-5, 3}});
+
+    return map;
+}
+
+// состояние в том виде, как его строил обработчик через json::object
+json::value ReferenceDog(const model::Dog& dog) {
+    std::string direction;
+
+    switch (dog.direction) {
+    case model::NORTH:
+        direction = "U"s;
+        break;
+    case model::SOUTH:
+        direction = "D"s;
+        break;
+    case model::EAST:
+        direction = "R"s;
+        break;
+    case model::WEST:
+        direction = "L"s;
+        break;
+    }
+
+    return {
+        {"pos"s, {dog.coord.x, dog.coord.y}},
+        {"speed"s, {dog.speed.vx, dog.speed.vy}},
+        {"dir"s, direction}
+    };
+}
+
+json::value ReferenceGameState(model::GameSession& session) {
+    json::object obj;
+
+    for (const auto& dog : session.GetDogs()) {
+        obj[std::to_string(dog.playerId)] = ReferenceDog(dog);
+    }
+
+    return json::object {{"players"s, obj}};
+}
+
+}  // namespace
+
+SCENARIO("Streaming JSON writer matches boost::json::serialize") {
+    GIVEN("maps with special characters in names") {
+        model::Game::Maps maps;
+        maps.emplace_back(MakeMap("map1"s, "Map 1"s));
+        maps.emplace_back(MakeMap("town"s, "Town \"quoted\" \\ back\nslash\t\x01 и юникод"s));
+
+        THEN("map list is identical") {
+            std::vector<dto::MapRegistryDto> dtos(maps.begin(), maps.end());
+
+            std::string out;
+            json_writer::WriteMaps(out, maps);
+
+            CHECK(out == json::serialize(json::value_from(dtos)));
+        }
+
+        THEN("map details are identical") {
+            for (const auto& map : maps) {
+                std::string out;
+                json_writer::WriteMap(out, map);
+
+                CHECK(out == json::serialize(json::value_from(&map)));
+            }
+        }
+    }
+
+    GIVEN("an auth token") {
+        dto::AuthTokenDto token {"0123456789abcdef0123456789abcdef"s, 42};
+
+        std::string out;
+        json_writer::WriteAuthToken(out, token);
+
+        CHECK(out == json::serialize(json::value_from(token)));
+    }
+
+    GIVEN("a list of players") {
+        std::vector<app::Player> players {
+            {1, "Rex"s, 1, "t1"s, 1},
+            {7, "Pes \"Barbos\""s, 1, "t2"s, 2},
+        };
+
+        json::object reference;
+
+        for (const auto& player : players) {
+            reference[std::to_string(player.id)] = {{"name"s, player.name}};
+        }
+
+        std::string out;
+        json_writer::WritePlayers(out, players);
+
+        CHECK(out == json::serialize(reference));
+    }
+
+    GIVEN("a game session with dogs at various positions") {
+        model::GameSession session {1, std::make_shared<const model::Map>(model::Map::Id{"map1"s}, "Map 1"s)};
+
+        const std::vector<double> values {
+            0.0, -0.0, 1.0, 4.0, 0.4, 40.4, 1.0 / 3.0, -2.5, 1e-7, 123456789.0, 1e21, -1e-300,
+            std::numeric_limits<double>::max(), std::nextafter(10.0, 11.0)
+        };
+
+        int playerId = 1;
+
+        for (double x : values) {
+            for (double y : values) {
+                auto& dog = session.AddDog(playerId++, {x, y}, 0);
+                dog.speed = {y, -x};
+                dog.direction = static_cast<model::Direction>(playerId % 4);
+            }
+        }
+
+        THEN("state is identical") {
+            std::string out;
+            json_writer::WriteGameState(out, session);
+
+            CHECK(out == json::serialize(ReferenceGameState(session)));
+        }
+    }
+}
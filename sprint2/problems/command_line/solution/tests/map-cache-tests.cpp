@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include "../src/map_cache.h"
+#include "../src/road_graph.h"
+
+using namespace std::literals;
+
+namespace {
+    model::Game MakeGame() {
+        model::Game game;
+
+        game.SetDefaultDogSpeed(2.5);
+        game.SetDefaultSessionCapacity(8);
+        game.SetDogRetirementTime(15000);
+
+        model::Map town {model::Map::Id{"town"s}, "Town"s};
+
+        town.AddRoad(model::Road{model::Road::HORIZONTAL, {0, 0}, 40});
+        town.AddRoad(model::Road{model::Road::VERTICAL, {40, 0}, 30});
+        town.AddBuilding(model::Building{model::Rectangle{{5, 5}, {30, 20}}});
+        town.AddOffice(model::Office{model::Office::Id{"o0"s}, {40, 30}, {5, 0}});
+        town.SetDogSpeed(4);
+
+        model::Map village {model::Map::Id{"village"s}, "Village"s};
+
+        village.AddRoad(model::Road{model::Road::VERTICAL, {0, 0}, 10});
+        // дорога нулевой длины: направление по концам не определить
+        village.AddRoad(model::Road{model::Road::VERTICAL, {5, 5}, 5});
+        village.SetSessionCapacity(2);
+
+        game.AddMap(std::move(town));
+        game.AddMap(std::move(village));
+
+        return game;
+    }
+}
+
+SCENARIO("Binary map cache") {
+    const auto config = map_cache::FingerprintConfig(R"({"maps": []})"sv);
+    const auto game = MakeGame();
+
+    std::string data;
+    map_cache::EncodeGame(data, game, config);
+
+    GIVEN("a cache built from the same config") {
+        auto cached = map_cache::DecodeGame(data, config);
+
+        THEN("the game is restored with all maps and settings") {
+            REQUIRE(cached.has_value());
+
+            CHECK(cached->GetDefaultDogSpeed() == 2.5);
+            CHECK(cached->GetDefaultSessionCapacity() == 8);
+            CHECK(cached->GetDogRetirementTime() == 15000);
+            REQUIRE(cached->GetMaps().size() == 2);
+
+            const auto* town = cached->FindMap(model::Map::Id{"town"s});
+            REQUIRE(town != nullptr);
+            CHECK(town->GetName() == "Town"s);
+            REQUIRE(town->GetRoads().size() == 2);
+            CHECK(town->GetRoads()[0].IsHorizontal());
+            CHECK(town->GetRoads()[0].GetEnd().x == 40);
+            CHECK(town->GetRoads()[1].IsVertical());
+            CHECK(town->GetRoads()[1].GetEnd().y == 30);
+            REQUIRE(town->GetBuildings().size() == 1);
+            CHECK(town->GetBuildings()[0].GetBounds().size.width == 30);
+            REQUIRE(town->GetOffices().size() == 1);
+            CHECK(*town->GetOffices()[0].GetId() == "o0"s);
+            CHECK(town->GetOffices()[0].GetOffset().dx == 5);
+            CHECK(town->GetDogSpeed() == 4.0);
+            CHECK_FALSE(town->GetSessionCapacity().has_value());
+
+            const auto* village = cached->FindMap(model::Map::Id{"village"s});
+            REQUIRE(village != nullptr);
+            CHECK_FALSE(village->GetDogSpeed().has_value());
+            CHECK(village->GetSessionCapacity() == 2);
+            REQUIRE(village->GetRoads().size() == 2);
+            CHECK(village->GetRoads()[1].IsVertical());
+            CHECK(village->GetRoads()[1].GetEnd().y == 5);
+        }
+
+        THEN("road graphs are built") {
+            CHECK(cached->GetMaps()[0].GetRoadGraph().GetRoads().size() == 2);
+        }
+    }
+
+    GIVEN("a changed config") {
+        THEN("the cache is rejected") {
+            CHECK_FALSE(map_cache::DecodeGame(data, map_cache::FingerprintConfig(R"({"maps": [ ]})"sv)).has_value());
+        }
+    }
+
+    GIVEN("a truncated or corrupted cache") {
+        THEN("the cache is rejected") {
+            CHECK_FALSE(map_cache::DecodeGame(std::string_view{data}.substr(0, data.size() - 3), config).has_value());
+            CHECK_FALSE(map_cache::DecodeGame(data + "x"s, config).has_value());
+            CHECK_FALSE(map_cache::DecodeGame("GSMC"sv, config).has_value());
+        }
+    }
+
+    GIVEN("a cache file") {
+        const auto path = std::filesystem::temp_directory_path() / "map-cache-test.json.cache";
+
+        REQUIRE(map_cache::StoreCachedGame(path, game, config));
+
+        THEN("it is loaded while the config is unchanged") {
+            CHECK(map_cache::LoadCachedGame(path, config).has_value());
+            CHECK_FALSE(map_cache::LoadCachedGame(path, map_cache::FingerprintConfig("{}"sv)).has_value());
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    GIVEN("a config read in chunks") {
+        const auto content = std::string(100'000, 'x') + "tail"s;
+        const auto path = std::filesystem::temp_directory_path() / "map-cache-test.json";
+
+        {
+            std::ofstream ofs {path, std::ios::binary};
+            ofs << content;
+        }
+
+        THEN("its fingerprint matches the one of the whole content") {
+            CHECK(map_cache::FingerprintFile(path) == map_cache::FingerprintConfig(content));
+        }
+
+        std::filesystem::remove(path);
+    }
+}
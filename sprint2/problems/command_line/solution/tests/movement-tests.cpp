@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <vector>
+
+#include "../src/movement.h"
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+// карта в виде буквы Т: горизонтальная дорога (0,0)-(40,0),
+// продолжающаяся горизонтальной дорогой (40,0)-(100,0), и вертикальная (40,0)-(40,30)
+model::Map MakeMap() {
+    model::Map map{model::Map::Id{"map"}, "map"};
+
+    map.AddRoad(model::Road{model::Road::HORIZONTAL, {0, 0}, 40});
+    map.AddRoad(model::Road{model::Road::HORIZONTAL, {40, 0}, 100});
+    map.AddRoad(model::Road{model::Road::VERTICAL, {40, 0}, 30});
+
+    return map;
+}
+
+}  // namespace
+
+SCENARIO("Continuous dog movement") {
+    const model::RoadGraph graph{MakeMap().GetRoads()};
+
+    GIVEN("a dog moving right along connected roads") {
+        model::Dog dog{1, 1, {10, 0}, graph.GetRoadOf(0)};
+        dog.speed = {5, 0};
+
+        WHEN("a long tick passes") {
+            app::MoveDog(dog, graph, 3600);
+
+            THEN("the dog passes the junction and stops at the far end of the road") {
+                CHECK_THAT(dog.coord.x, WithinAbs(100.4, 1e-9));
+                CHECK(dog.coord.y == 0);
+                CHECK(dog.speed.vx == 0);
+            }
+        }
+
+        WHEN("the same time passes in many small ticks") {
+            model::Dog stepped = dog;
+
+            for (int i = 0; i < 360'000; ++i) {
+                app::MoveDog(stepped, graph, 0.01);
+            }
+
+            app::MoveDog(dog, graph, 3600);
+
+            THEN("the result is the same as for one long tick") {
+                CHECK_THAT(stepped.coord.x, WithinAbs(dog.coord.x, 1e-9));
+                CHECK(stepped.speed.vx == dog.speed.vx);
+            }
+        }
+
+        WHEN("a short tick passes") {
+            app::MoveDog(dog, graph, 1);
+
+            THEN("the dog keeps moving") {
+                CHECK_THAT(dog.coord.x, WithinAbs(15, 1e-9));
+                CHECK(dog.speed.vx == 5);
+            }
+        }
+    }
+
+    GIVEN("a dog moving down off the horizontal road") {
+        model::Dog dog{1, 1, {10, 0}, graph.GetRoadOf(0)};
+        dog.speed = {0, 5};
+
+        app::MoveDog(dog, graph, 10);
+
+        THEN("it stops at the road edge") {
+            CHECK_THAT(dog.coord.y, WithinAbs(0.4, 1e-9));
+            CHECK(dog.speed.vy == 0);
+        }
+    }
+
+    GIVEN("a dog on the horizontal road at the junction moving down") {
+        model::Dog dog{1, 1, {40, 0}, graph.GetRoadOf(0)};
+        dog.speed = {0, 5};
+
+        app::MoveDog(dog, graph, 100);
+
+        THEN("it follows the vertical road to its end") {
+            CHECK_THAT(dog.coord.y, WithinAbs(30.4, 1e-9));
+        }
+    }
+
+    GIVEN("a dog that is standing still") {
+        model::Dog dog{1, 1, {10, 0}, graph.GetRoadOf(0)};
+
+        app::MoveDog(dog, graph, 3600);
+
+        THEN("nothing changes") {
+            CHECK(dog.coord.x == 10);
+            CHECK(dog.coord.y == 0);
+        }
+    }
+}
+
+SCENARIO("Active dogs tracking") {
+    model::GameSession session{1, std::make_shared<const model::Map>(model::Map::Id{"map"}, "Map")};
+
+    std::vector<model::DogId> ids;
+
+    for (int i = 0; i < 3; ++i) {
+        ids.push_back(session.AddDog(i + 1, {10, 0}, 0).id);
+    }
+
+    auto start = [&session](model::DogId id) {
+        auto& dog = *session.GetDog(id);
+        dog.speed = {1, 0};
+        session.MarkChanged(dog);
+    };
+
+    GIVEN("dogs that have just joined") {
+        THEN("none of them is active") {
+            CHECK(session.GetActiveDogCount() == 0);
+        }
+    }
+
+    GIVEN("two dogs that started moving") {
+        start(ids[0]);
+        start(ids[2]);
+
+        THEN("only they are visited") {
+            std::vector<model::DogId> visited;
+            session.ForEachActiveDog([&visited](model::Dog& dog) { visited.push_back(dog.id); });
+
+            std::ranges::sort(visited);
+            CHECK(visited == std::vector{ids[0], ids[2]});
+        }
+
+        WHEN("a dog stops while being visited") {
+            session.ForEachActiveDog([&session, &ids](model::Dog& dog) {
+                if (dog.id == ids[2]) {
+                    dog.speed = {};
+                    session.MarkChanged(dog);
+                }
+            });
+
+            THEN("it leaves the active set") {
+                REQUIRE(session.GetActiveDogCount() == 1);
+
+                session.ForEachActiveDog([&ids](model::Dog& dog) { CHECK(dog.id == ids[0]); });
+            }
+        }
+
+        WHEN("a moving dog is removed") {
+            session.RemoveDog(ids[0]);
+
+            THEN("the other one stays active") {
+                REQUIRE(session.GetActiveDogCount() == 1);
+
+                session.ForEachActiveDog([&ids](model::Dog& dog) { CHECK(dog.id == ids[2]); });
+            }
+
+            THEN("clients need a full snapshot") {
+                CHECK_FALSE(session.CanDeltaFrom(session.GetVersion() - 1));
+                CHECK(session.CanDeltaFrom(session.GetVersion()));
+            }
+        }
+    }
+}
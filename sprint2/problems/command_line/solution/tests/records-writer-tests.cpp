@@ -0,0 +1,292 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <string>
+#include <vector>
+
+#include "../src/records.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Хранилище в памяти: запоминает пачки и может отказывать заданное число раз
+class FakeRepository : public records::RecordsRepository {
+public:
+    void Save(const std::vector<records::Record>& batch) override {
+        std::lock_guard lock {_mutex};
+
+        ++_attempts;
+
+        if (_failures > 0) {
+            --_failures;
+            throw std::runtime_error("database is unavailable");
+        }
+
+        _batches.push_back(batch);
+        _saved.notify_all();
+    }
+
+    std::vector<records::Record> Load(size_t, size_t) override {
+        return {};
+    }
+
+    void FailNext(unsigned failures) {
+        std::lock_guard lock {_mutex};
+        _failures = failures;
+    }
+
+    // ждет, пока сохранится хотя бы count пачек
+    bool WaitBatches(size_t count) {
+        std::unique_lock lock {_mutex};
+        return _saved.wait_for(lock, 5s, [this, count] { return _batches.size() >= count; });
+    }
+
+    std::vector<size_t> GetBatchSizes() const {
+        std::lock_guard lock {_mutex};
+
+        std::vector<size_t> sizes;
+
+        for (const auto& batch : _batches) {
+            sizes.push_back(batch.size());
+        }
+
+        return sizes;
+    }
+
+    std::vector<std::string> GetNames() const {
+        std::lock_guard lock {_mutex};
+
+        std::vector<std::string> names;
+
+        for (const auto& batch : _batches) {
+            for (const auto& record : batch) {
+                names.push_back(record.name);
+            }
+        }
+
+        return names;
+    }
+
+    unsigned GetAttempts() const {
+        std::lock_guard lock {_mutex};
+        return _attempts;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _saved;
+    std::vector<std::vector<records::Record>> _batches;
+    unsigned _failures = 0;
+    unsigned _attempts = 0;
+};
+
+// Хранилище, которое сначала бросает исключение с пустым what(), затем не std::exception
+class OddFailuresRepository : public records::RecordsRepository {
+public:
+    void Save(const std::vector<records::Record>& batch) override {
+        std::lock_guard lock {_mutex};
+
+        switch (_attempts++) {
+        case 0:
+            throw std::runtime_error("");
+        case 1:
+            throw 42;
+        }
+
+        _saved += batch.size();
+    }
+
+    std::vector<records::Record> Load(size_t, size_t) override {
+        return {};
+    }
+
+    size_t GetSaved() const {
+        std::lock_guard lock {_mutex};
+        return _saved;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    unsigned _attempts = 0;
+    size_t _saved = 0;
+};
+
+std::vector<records::Record> MakeRecords(size_t count, size_t first = 0) {
+    std::vector<records::Record> result;
+
+    for (size_t i = first; i < first + count; ++i) {
+        result.push_back({"dog"s + std::to_string(i), i * 10, static_cast<int64_t>(i) * 1000});
+    }
+
+    return result;
+}
+
+std::vector<std::string> MakeNames(size_t count) {
+    std::vector<std::string> result;
+
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back("dog"s + std::to_string(i));
+    }
+
+    return result;
+}
+
+// ждет, пока писатель отбросит хотя бы count результатов
+bool WaitDropped(const records::RecordsWriter& writer, size_t count) {
+    for (auto deadline = std::chrono::steady_clock::now() + 5s; std::chrono::steady_clock::now() < deadline;) {
+        if (writer.GetDropped() >= count) {
+            return true;
+        }
+
+        std::this_thread::sleep_for(1ms);
+    }
+
+    return false;
+}
+
+// период, который не наступит за время теста: запись идет только по полной пачке или остановке
+constexpr auto NEVER = std::chrono::hours(1);
+
+}  // namespace
+
+SCENARIO("Records writer") {
+    FakeRepository repository;
+
+    GIVEN("a writer with a short flush period") {
+        records::RecordsWriter writer {repository, {.flushPeriod = 10ms}};
+
+        THEN("pushed records are saved without waiting for a full batch") {
+            CHECK(writer.Push(MakeRecords(3)) == 3);
+            REQUIRE(repository.WaitBatches(1));
+            CHECK(repository.GetNames() == MakeNames(3));
+        }
+    }
+
+    GIVEN("a writer with small batches") {
+        records::RecordsWriter writer {repository, {.flushPeriod = NEVER, .maxBatch = 2}};
+
+        THEN("a full batch is saved before the flush period") {
+            writer.Push(MakeRecords(2));
+            REQUIRE(repository.WaitBatches(1));
+            CHECK(repository.GetBatchSizes() == std::vector<size_t>{2});
+        }
+
+        THEN("the queue is split into batches of at most maxBatch in push order") {
+            writer.Push(MakeRecords(5));
+            writer.Stop();
+
+            CHECK(repository.GetBatchSizes() == std::vector<size_t>{2, 2, 1});
+            CHECK(repository.GetNames() == MakeNames(5));
+            CHECK(writer.GetPending() == 0);
+        }
+    }
+
+    GIVEN("a writer with a long flush period") {
+        THEN("destruction saves what is left in the queue") {
+            {
+                records::RecordsWriter writer {repository, {.flushPeriod = NEVER}};
+                writer.Push(MakeRecords(2));
+                writer.Push(MakeRecords(1, 2));
+            }
+
+            CHECK(repository.GetBatchSizes() == std::vector<size_t>{3});
+            CHECK(repository.GetNames() == MakeNames(3));
+        }
+
+        THEN("a second Stop does nothing") {
+            records::RecordsWriter writer {repository, {.flushPeriod = NEVER}};
+            writer.Push(MakeRecords(1));
+            writer.Stop();
+            writer.Stop();
+
+            CHECK(repository.GetBatchSizes() == std::vector<size_t>{1});
+        }
+    }
+
+    GIVEN("a repository that fails a few times") {
+        repository.FailNext(2);
+
+        THEN("the batch is retried and saved once") {
+            records::RecordsWriter writer {repository, {.flushPeriod = NEVER, .maxAttempts = 3, .retryDelay = 1ms}};
+            writer.Push(MakeRecords(4));
+            writer.Stop();
+
+            CHECK(repository.GetAttempts() == 3);
+            CHECK(repository.GetNames() == MakeNames(4));
+            CHECK(writer.GetDropped() == 0);
+        }
+
+        THEN("a batch that ran out of attempts is kept for the next period") {
+            records::RecordsWriter writer {repository, {.flushPeriod = 10ms, .maxAttempts = 1, .retryDelay = 1ms}};
+            writer.Push(MakeRecords(2));
+
+            REQUIRE(repository.WaitBatches(1));
+            CHECK(repository.GetNames() == MakeNames(2));
+            CHECK(writer.GetDropped() == 0);
+        }
+
+        THEN("a batch that fails maxFailedPeriods periods is dropped and the next one is saved") {
+            records::RecordsWriter writer {repository, {.flushPeriod = 10ms, .maxBatch = 2, .maxAttempts = 1, .retryDelay = 1ms, .maxFailedPeriods = 2}};
+            writer.Push(MakeRecords(4));
+
+            REQUIRE(repository.WaitBatches(1));
+            CHECK(writer.GetDropped() == 2);
+            CHECK(repository.GetNames() == std::vector<std::string>{"dog2"s, "dog3"s});
+        }
+    }
+
+    GIVEN("a repository that fails without a message or with a non-std exception") {
+        OddFailuresRepository oddRepository;
+
+        THEN("both failures are retried and the batch is saved") {
+            records::RecordsWriter writer {oddRepository, {.flushPeriod = NEVER, .maxAttempts = 3, .retryDelay = 1ms}};
+            writer.Push(MakeRecords(2));
+            writer.Stop();
+
+            CHECK(oddRepository.GetSaved() == 2);
+            CHECK(writer.GetDropped() == 0);
+        }
+    }
+
+    GIVEN("a repository that never accepts a batch") {
+        repository.FailNext(1'000'000);
+
+        records::RecordsWriter writer {repository, {.flushPeriod = 1ms, .maxAttempts = 1, .retryDelay = 1ms, .maxFailedPeriods = 3}};
+
+        THEN("the queue is not blocked forever") {
+            writer.Push(MakeRecords(2));
+
+            REQUIRE(WaitDropped(writer, 2));
+            CHECK(writer.GetPending() == 0);
+        }
+    }
+
+    GIVEN("a repository that is down") {
+        repository.FailNext(100);
+
+        std::vector<std::string> errors;
+
+        records::RecordsWriter writer {repository, {.flushPeriod = NEVER, .capacity = 3, .maxAttempts = 2, .retryDelay = 1ms},
+                                       [&errors](const std::string& message) { errors.push_back(message); }};
+
+        THEN("records over capacity are dropped and counted") {
+            CHECK(writer.Push(MakeRecords(5)) == 3);
+            CHECK(writer.GetDropped() == 2);
+            CHECK(writer.GetPending() == 3);
+            CHECK(errors.size() == 1);
+        }
+
+        THEN("records that cannot be saved on stop are dropped and counted") {
+            writer.Push(MakeRecords(3));
+            writer.Stop();
+
+            CHECK(repository.GetAttempts() == 2);
+            CHECK(writer.GetDropped() == 3);
+            CHECK(writer.GetPending() == 0);
+        }
+    }
+}
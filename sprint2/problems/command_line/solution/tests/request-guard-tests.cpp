@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/request_guard.h"
+
+using namespace std::literals;
+using http_handler::Clock;
+using Decision = http_handler::RequestGuard::Decision;
+
+SCENARIO("Per-token rate limiting") {
+    http_handler::RateLimiter limiter {10, 3};
+    const auto start = Clock::now();
+
+    GIVEN("a token that sends a burst of requests") {
+        THEN("requests above the burst are rejected") {
+            CHECK(limiter.TryAcquire("a"sv, start));
+            CHECK(limiter.TryAcquire("a"sv, start));
+            CHECK(limiter.TryAcquire("a"sv, start));
+            CHECK_FALSE(limiter.TryAcquire("a"sv, start));
+
+            AND_THEN("other tokens are not affected") {
+                CHECK(limiter.TryAcquire("b"sv, start));
+            }
+
+            AND_THEN("the bucket refills with time") {
+                CHECK(limiter.TryAcquire("a"sv, start + 100ms));
+                CHECK_FALSE(limiter.TryAcquire("a"sv, start + 100ms));
+            }
+        }
+    }
+}
+
+SCENARIO("Load shedding") {
+    http_handler::RequestGuardConfig config;
+    config.maxQueueDepth = 2;
+    config.maxQueueWait = 10ms;
+
+    http_handler::RequestGuard guard {config};
+
+    GIVEN("a full strand queue") {
+        REQUIRE(guard.Admit(""sv) == Decision::Accept);
+        REQUIRE(guard.Admit(""sv) == Decision::Accept);
+
+        THEN("new requests are shed until the queue drains") {
+            CHECK(guard.Admit(""sv) == Decision::Shed);
+
+            guard.OnDequeued(0ms);
+
+            CHECK(guard.Admit(""sv) == Decision::Accept);
+            CHECK(guard.GetCounters().shed == 1);
+        }
+    }
+
+    GIVEN("requests admitted and executed outside the strand") {
+        REQUIRE(guard.Admit(""sv) == Decision::Accept);
+        guard.OnBypassed();
+        REQUIRE(guard.Admit(""sv) == Decision::Accept);
+        guard.OnBypassed();
+
+        THEN("they do not occupy the queue") {
+            CHECK(guard.GetQueueDepth() == 0);
+            CHECK(guard.Admit(""sv) == Decision::Accept);
+            CHECK(guard.Admit(""sv) == Decision::Accept);
+        }
+    }
+
+    GIVEN("requests that waited too long in the queue") {
+        for (int i = 0; i < 40; ++i) {
+            REQUIRE(guard.Admit(""sv) == Decision::Accept);
+            guard.OnDequeued(100ms);
+        }
+
+        REQUIRE(guard.Admit(""sv) == Decision::Accept);
+
+        THEN("requests are shed while the queue is not empty") {
+            CHECK(guard.Admit(""sv) == Decision::Shed);
+
+            guard.OnDequeued(0ms);
+
+            AND_THEN("an empty queue accepts requests again") {
+                CHECK(guard.Admit(""sv) == Decision::Accept);
+            }
+        }
+    }
+
+    GIVEN("a token over its limit") {
+        http_handler::RequestGuardConfig limited;
+        limited.burst = 1;
+
+        http_handler::RequestGuard strict {limited};
+
+        REQUIRE(strict.Admit("t"sv) == Decision::Accept);
+
+        THEN("it is throttled and counted") {
+            CHECK(strict.Admit("t"sv) == Decision::Throttle);
+            CHECK(strict.GetCounters().throttled == 1);
+            CHECK(strict.GetCounters().queueDepth == 1);
+        }
+    }
+}
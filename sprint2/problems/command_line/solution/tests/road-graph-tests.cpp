@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/road_graph.h"
+
+SCENARIO("Road graph") {
+    GIVEN("collinear roads that overlap or touch") {
+        model::Map::Roads roads{
+            model::Road{model::Road::HORIZONTAL, {0, 0}, 10},
+            model::Road{model::Road::HORIZONTAL, {20, 0}, 10},
+            model::Road{model::Road::HORIZONTAL, {15, 0}, 30},
+            model::Road{model::Road::HORIZONTAL, {40, 0}, 50},
+        };
+
+        const model::RoadGraph graph{roads};
+
+        THEN("they are merged into one road, separate ones are kept") {
+            REQUIRE(graph.GetRoads().size() == 2);
+
+            CHECK(graph.GetRoadOf(0) == graph.GetRoadOf(1));
+            CHECK(graph.GetRoadOf(1) == graph.GetRoadOf(2));
+            CHECK(graph.GetRoadOf(3) != graph.GetRoadOf(0));
+
+            const auto& merged = graph.GetRoads()[graph.GetRoadOf(0)].road;
+            CHECK(merged.GetStart().x == 0);
+            CHECK(merged.GetEnd().x == 30);
+        }
+
+        THEN("roads that do not touch are not linked") {
+            CHECK(graph.GetNodes().empty());
+        }
+    }
+
+    GIVEN("a cross of two roads and a distant vertical road") {
+        model::Map::Roads roads{
+            model::Road{model::Road::HORIZONTAL, {0, 10}, 20},
+            model::Road{model::Road::VERTICAL, {10, 0}, 20},
+            model::Road{model::Road::VERTICAL, {30, 0}, 20},
+        };
+
+        const model::RoadGraph graph{roads};
+
+        const size_t horizontal = graph.GetRoadOf(0);
+        const size_t vertical = graph.GetRoadOf(1);
+
+        THEN("the crossing roads are linked through one node") {
+            REQUIRE(graph.GetNodes().size() == 1);
+
+            const auto& links = graph.GetRoads()[horizontal].links;
+            REQUIRE(links.size() == 1);
+            CHECK(links[0].road == vertical);
+
+            const auto& area = graph.GetNodes()[links[0].node].area;
+            CHECK(area.x_min == 9.6);
+            CHECK(area.x_max == 10.4);
+            CHECK(area.y_min == 9.6);
+            CHECK(area.y_max == 10.4);
+
+            CHECK(graph.GetRoads()[graph.GetRoadOf(2)].links.empty());
+        }
+    }
+}
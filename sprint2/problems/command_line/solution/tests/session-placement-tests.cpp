@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/model.h"
+
+SCENARIO("Session placement") {
+    model::Game game;
+
+    model::Map map{model::Map::Id{"map1"}, "Map 1"};
+    map.SetSessionCapacity(2);
+    game.AddMap(std::move(map));
+
+    const model::Map::Id mapId{"map1"};
+
+    auto join = [&game, &mapId, playerId = 0]() mutable -> model::GameSession& {
+        auto& session = game.PlaceNewPlayer(mapId);
+        session.AddDog(++playerId, {0, 0}, 0);
+        return session;
+    };
+
+    GIVEN("a map with session capacity 2") {
+        THEN("the first two players share a session") {
+            const auto first = join().GetId();
+            CHECK(join().GetId() == first);
+
+            AND_THEN("the third player gets a new session") {
+                CHECK(join().GetId() != first);
+                CHECK(game.GetSessions().size() == 2);
+            }
+        }
+    }
+
+    GIVEN("two sessions with free places") {
+        join();
+        join();
+        join();
+
+        THEN("a new player goes to the least loaded one") {
+            auto& session = join();
+
+            CHECK(session.GetId() == 2);
+            CHECK(game.GetSessions().size() == 2);
+        }
+    }
+
+    GIVEN("a map without capacity in config") {
+        game.AddMap(model::Map{model::Map::Id{"map2"}, "Map 2"});
+
+        THEN("all players join one session") {
+            for (int i = 0; i < 10; ++i) {
+                game.PlaceNewPlayer(model::Map::Id{"map2"}).AddDog(i + 1, {0, 0}, 0);
+            }
+
+            CHECK(game.GetSessions().size() == 1);
+        }
+    }
+}
+
+SCENARIO("Maps reload") {
+    model::Game game;
+
+    model::Map map{model::Map::Id{"map1"}, "Map 1"};
+    map.SetSessionCapacity(2);
+    game.AddMap(std::move(map));
+
+    const model::Map::Id mapId{"map1"};
+
+    auto& oldSession = game.PlaceNewPlayer(mapId);
+    oldSession.AddDog(1, {0, 0}, 0);
+    const auto oldSessionId = oldSession.GetId();
+
+    GIVEN("a new config with a changed map") {
+        model::Game loaded;
+
+        model::Map newMap{model::Map::Id{"map1"}, "Map 1 v2"};
+        newMap.SetSessionCapacity(2);
+        loaded.AddMap(std::move(newMap));
+        loaded.AddMap(model::Map{model::Map::Id{"map3"}, "Map 3"});
+        loaded.SetDefaultDogSpeed(5);
+        loaded.SetDogRetirementTime(15'000);
+
+        game.ReplaceMaps(std::move(loaded));
+
+        THEN("new maps and settings are used") {
+            CHECK(game.GetMaps().size() == 2);
+            REQUIRE(game.FindMap(model::Map::Id{"map3"}) != nullptr);
+            CHECK(game.FindMap(mapId)->GetName() == "Map 1 v2");
+            CHECK(game.GetDefaultDogSpeed() == 5);
+        }
+
+        THEN("dogRetirementTime is not reloaded") {
+            CHECK_FALSE(game.GetDogRetirementTime().has_value());
+        }
+
+        THEN("existing sessions keep their old map") {
+            CHECK(game.GetSession(oldSessionId)->GetMap().GetName() == "Map 1");
+        }
+
+        THEN("new players join sessions of the new map") {
+            auto& session = game.PlaceNewPlayer(mapId);
+
+            CHECK(session.GetId() != oldSessionId);
+            CHECK(session.GetMap().GetName() == "Map 1 v2");
+
+            AND_THEN("the old session is removed when it drains") {
+                CHECK(game.RemoveSession(oldSessionId));
+                CHECK(game.GetSessions().size() == 1);
+            }
+        }
+    }
+
+    GIVEN("a map added after a session was created") {
+        for (int i = 2; i < 10; ++i) {
+            game.AddMap(model::Map{model::Map::Id{"extra" + std::to_string(i)}, "Extra"});
+        }
+
+        THEN("the session still refers to its map") {
+            CHECK(game.GetSession(oldSessionId)->GetMap().GetName() == "Map 1");
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "../src/slot_map.h"
+
+using namespace std::literals;
+
+SCENARIO("Slot map") {
+    util::SlotMap<std::string> values;
+
+    GIVEN("several inserted values") {
+        const auto a = values.PeekNextId();
+        values.Emplace("a"s);
+        const auto b = values.PeekNextId();
+        values.Emplace("b"s);
+        const auto c = values.PeekNextId();
+        values.Emplace("c"s);
+
+        THEN("they are found by id") {
+            REQUIRE(values.size() == 3);
+            CHECK(*values.Find(a) == "a"s);
+            CHECK(*values.Find(b) == "b"s);
+            CHECK(*values.Find(c) == "c"s);
+            CHECK(values.Find(0) == nullptr);
+        }
+
+        WHEN("a value is erased") {
+            REQUIRE(values.Erase(a));
+
+            THEN("other ids stay valid and the erased one is gone") {
+                CHECK(values.size() == 2);
+                CHECK(values.Find(a) == nullptr);
+                CHECK(*values.Find(b) == "b"s);
+                CHECK(*values.Find(c) == "c"s);
+                CHECK_FALSE(values.Erase(a));
+            }
+
+            AND_WHEN("its slot is reused") {
+                const auto d = values.PeekNextId();
+                values.Emplace("d"s);
+
+                THEN("the old id does not find the new value") {
+                    CHECK(d != a);
+                    CHECK(values.Find(a) == nullptr);
+                    CHECK(*values.Find(d) == "d"s);
+                }
+            }
+        }
+
+        THEN("the next id is not found before insertion") {
+            REQUIRE(values.Erase(b));
+            CHECK(values.Find(values.PeekNextId()) == nullptr);
+        }
+
+        THEN("iteration visits all values") {
+            values.Erase(b);
+
+            std::vector<std::string> all(values.begin(), values.end());
+            CHECK(all.size() == 2);
+        }
+    }
+}
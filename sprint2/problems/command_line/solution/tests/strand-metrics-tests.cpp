@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/strand_metrics.h"
+
+using namespace std::literals;
+using http_handler::API_ROUTES;
+using http_handler::GetRouteIndex;
+
+SCENARIO("Histogram buckets") {
+    GIVEN("a histogram with bounds 10, 100") {
+        constexpr std::array<uint64_t, 2> bounds {10, 100};
+        http_handler::Histogram histogram {bounds};
+
+        WHEN("values are recorded") {
+            histogram.Record(0);
+            histogram.Record(10);
+            histogram.Record(11);
+            histogram.Record(100);
+            histogram.Record(1000);
+
+            THEN("each value lands in the first bucket whose bound is not less than it") {
+                CHECK(histogram.GetCount(0) == 2);
+                CHECK(histogram.GetCount(1) == 2);
+                CHECK(histogram.GetCount(2) == 1);
+                CHECK(histogram.GetTotal() == 5);
+                CHECK(histogram.GetSum() == 1121);
+            }
+        }
+    }
+}
+
+SCENARIO("Route classification") {
+    THEN("known paths map to their routes") {
+        CHECK(API_ROUTES[GetRouteIndex("/api/v1/maps"sv)] == "/api/v1/maps"sv);
+        CHECK(API_ROUTES[GetRouteIndex("/api/v1/maps/map1"sv)] == "/api/v1/maps/{id}"sv);
+        CHECK(API_ROUTES[GetRouteIndex("/api/v1/game/state?since=3"sv)] == "/api/v1/game/state"sv);
+        CHECK(API_ROUTES[GetRouteIndex("/api/v1/game/player/action"sv)] == "/api/v1/game/player/action"sv);
+    }
+
+    THEN("unknown paths are counted as other") {
+        CHECK(API_ROUTES[GetRouteIndex("/api/v1/unknown"sv)] == "other"sv);
+        CHECK(API_ROUTES[GetRouteIndex("/api/v1/maps/"sv)] == "other"sv);
+    }
+}
+
+SCENARIO("Strand metrics per route") {
+    http_handler::StrandMetrics metrics;
+
+    GIVEN("requests passed through the strand") {
+        metrics.OnEnqueued(0);
+        metrics.OnEnqueued(3);
+
+        const auto route = GetRouteIndex("/api/v1/game/state"sv);
+
+        metrics.OnCompleted(route, 2ms, 40us);
+
+        THEN("queue depth at enqueue is recorded") {
+            CHECK(metrics.GetDepthHistogram().GetTotal() == 2);
+            CHECK(metrics.GetDepthHistogram().GetSum() == 3);
+        }
+
+        THEN("wait and execution time are recorded for the route only, in microseconds") {
+            CHECK(metrics.GetRoute(route).wait.GetSum() == 2000);
+            CHECK(metrics.GetRoute(route).execution.GetSum() == 40);
+            CHECK(metrics.GetRoute(route).execution.GetCount(0) == 1);
+            CHECK(metrics.GetRoute(GetRouteIndex("/api/v1/maps"sv)).wait.GetTotal() == 0);
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../src/timer_wheel.h"
+
+using Keys = std::vector<app::TimerWheel::Key>;
+
+SCENARIO("Timer wheel") {
+    app::TimerWheel wheel;
+
+    GIVEN("timers at near and far deadlines") {
+        wheel.Schedule(1, 15'000);
+        wheel.Schedule(2, 50);
+        wheel.Schedule(3, 5'000'000);
+
+        THEN("each fires exactly when the clock reaches its deadline") {
+            CHECK(wheel.Advance(49).empty());
+            CHECK(wheel.Advance(50) == Keys{2});
+            CHECK(wheel.Advance(14'999).empty());
+            CHECK(wheel.Advance(15'000) == Keys{1});
+            CHECK(wheel.Advance(4'999'999).empty());
+            CHECK(wheel.Advance(5'000'000) == Keys{3});
+            CHECK(wheel.size() == 0);
+        }
+
+        THEN("one long advance fires all of them in deadline order") {
+            CHECK(wheel.Advance(10'000'000) == Keys{2, 1, 3});
+        }
+    }
+
+    GIVEN("a rescheduled timer") {
+        const auto timer = wheel.Schedule(1, 100);
+        wheel.Advance(90);
+        REQUIRE(wheel.Reschedule(timer, 190));
+
+        THEN("it fires at the new deadline") {
+            CHECK(wheel.Advance(150).empty());
+            CHECK(wheel.Advance(190) == Keys{1});
+            CHECK_FALSE(wheel.Reschedule(timer, 300));
+        }
+    }
+
+    GIVEN("a cancelled timer") {
+        const auto timer = wheel.Schedule(1, 100);
+        REQUIRE(wheel.Cancel(timer));
+
+        THEN("it never fires") {
+            CHECK(wheel.Advance(1'000).empty());
+            CHECK_FALSE(wheel.Cancel(timer));
+        }
+    }
+
+    GIVEN("a deadline beyond the wheel horizon") {
+        wheel.Schedule(1, uint64_t{1} << 40);
+
+        THEN("it still fires on time") {
+            CHECK(wheel.Advance((uint64_t{1} << 40) - 1).empty());
+            CHECK(wheel.Advance(uint64_t{1} << 40) == Keys{1});
+        }
+    }
+
+    GIVEN("random operations") {
+        std::mt19937_64 random{42};
+        std::map<app::TimerWheel::Key, std::pair<app::TimerWheel::TimerId, uint64_t>> expected;
+        app::TimerWheel::Key nextKey = 0;
+
+        THEN("the wheel fires the same timers as a sorted reference") {
+            for (int step = 0; step < 20'000; ++step) {
+                const uint64_t range = random() % 2 ? 100 : 100'000;
+
+                switch (random() % 4) {
+                case 0: {
+                    const uint64_t deadline = wheel.GetNow() + 1 + random() % range;
+                    expected[nextKey] = {wheel.Schedule(nextKey, deadline), deadline};
+                    ++nextKey;
+                    break;
+                }
+                case 1:
+                    if (!expected.empty()) {
+                        auto& [timer, deadline] = std::next(expected.begin(), random() % expected.size())->second;
+                        deadline = wheel.GetNow() + 1 + random() % range;
+                        REQUIRE(wheel.Reschedule(timer, deadline));
+                    }
+                    break;
+                case 2:
+                    if (!expected.empty()) {
+                        auto it = std::next(expected.begin(), random() % expected.size());
+                        REQUIRE(wheel.Cancel(it->second.first));
+                        expected.erase(it);
+                    }
+                    break;
+                default: {
+                    const uint64_t now = wheel.GetNow() + random() % range;
+                    auto fired = wheel.Advance(now);
+
+                    Keys reference;
+                    for (auto it = expected.begin(); it != expected.end();) {
+                        if (it->second.second <= now) {
+                            reference.push_back(it->first);
+                            it = expected.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+
+                    std::ranges::sort(fired);
+                    REQUIRE(fired == reference);
+                }
+                }
+
+                REQUIRE(wheel.size() == expected.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+#include <thread>
+
+#include "../src/application.h"
+#include "../src/token_generator.h"
+
+using namespace std::literals;
+
+SCENARIO("Token generation") {
+    GIVEN("a token") {
+        const auto token = tokens::TokenGenerator::GenerateString();
+
+        THEN("it consists of 32 lowercase hex digits") {
+            REQUIRE(token.size() == 32);
+            CHECK(token.find_first_not_of("0123456789abcdef"s) == std::string::npos);
+        }
+    }
+
+    GIVEN("tokens generated from several threads") {
+        constexpr size_t THREADS = 4;
+        constexpr size_t TOKENS_PER_THREAD = 10'000;
+
+        std::vector<std::vector<std::string>> generated(THREADS);
+
+        {
+            std::vector<std::jthread> workers;
+
+            for (auto& tokens : generated) {
+                workers.emplace_back([&tokens] {
+                    for (size_t i = 0; i < TOKENS_PER_THREAD; ++i) {
+                        tokens.emplace_back(tokens::TokenGenerator::GenerateString());
+                    }
+                });
+            }
+        }
+
+        THEN("all tokens are unique") {
+            std::set<std::string> unique;
+
+            for (const auto& tokens : generated) {
+                unique.insert(tokens.begin(), tokens.end());
+            }
+
+            CHECK(unique.size() == THREADS * TOKENS_PER_THREAD);
+        }
+    }
+}
+
+// запуск: game_server_tests "[benchmark]"
+TEST_CASE("Join game throughput", "[.][benchmark]") {
+    model::Game game;
+    model::Map map {model::Map::Id{"map1"s}, "Map 1"s};
+
+    map.AddRoad({model::Road::HORIZONTAL, {0, 0}, 40});
+    game.AddMap(std::move(map));
+
+    app::Application application {game, false};
+
+    BENCHMARK("token generation") {
+        return tokens::TokenGenerator::Generate();
+    };
+
+    int playerNumber = 0;
+
+    BENCHMARK("join game") {
+        return application.JoinGame("player"s + std::to_string(playerNumber++), "map1"s);
+    };
+}
@@ -0,0 +1,122 @@
+#include "../src/parallel_gather.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace collision_detector;
+using namespace std::literals;
+
+namespace {
+
+class VectorProvider : public ItemGathererProvider {
+public:
+    VectorProvider(std::vector<Item> items, std::vector<Gatherer> gatherers)
+        : items_{std::move(items)}
+        , gatherers_{std::move(gatherers)} {
+    }
+
+    size_t ItemsCount() const override {
+        return items_.size();
+    }
+
+    Item GetItem(size_t idx) const override {
+        return items_[idx];
+    }
+
+    size_t GatherersCount() const override {
+        return gatherers_.size();
+    }
+
+    Gatherer GetGatherer(size_t idx) const override {
+        return gatherers_[idx];
+    }
+
+private:
+    std::vector<Item> items_;
+    std::vector<Gatherer> gatherers_;
+};
+
+// Собиратели за тик сдвигаются на несколько единиц по карте 1000×1000
+VectorProvider MakeProvider(size_t items_count, size_t gatherers_count) {
+    std::mt19937_64 random{1};
+    std::uniform_real_distribution<double> coord{0, 1000};
+    std::uniform_real_distribution<double> step{-3, 3};
+
+    std::vector<Item> items;
+    items.reserve(items_count);
+    for (size_t i = 0; i < items_count; ++i) {
+        items.push_back({{coord(random), coord(random)}, 0});
+    }
+
+    std::vector<Gatherer> gatherers;
+    gatherers.reserve(gatherers_count);
+    for (size_t i = 0; i < gatherers_count; ++i) {
+        const geom::Point2D start{coord(random), coord(random)};
+        gatherers.push_back({start, {start.x + step(random), start.y + step(random)}, 0.6});
+    }
+
+    return {std::move(items), std::move(gatherers)};
+}
+
+template <typename Fn>
+std::vector<GatheringEvent> Measure(std::string_view name, int runs, Fn&& fn) {
+    std::vector<GatheringEvent> events;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < runs; ++i) {
+        events = fn();
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start) / runs;
+
+    std::cout << name << ": "sv << elapsed.count() << " ms per call, "sv << events.size() << " events"sv << std::endl;
+
+    return events;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    constexpr size_t ITEMS = 100'000;
+    constexpr size_t GATHERERS = 10'000;
+
+    const auto provider = MakeProvider(ITEMS, GATHERERS);
+
+    std::cout << GATHERERS << " gatherers, "sv << ITEMS << " items"sv << std::endl;
+
+    const auto events = Measure("grid"sv, 20, [&provider] { return FindGatherEvents(provider); });
+
+    // те же данные, заранее сложенные в массивы: без копирования через виртуальные вызовы
+    const ItemGathererBuffers buffers{provider};
+    const auto batch_events = Measure("grid, batch provider"sv, 20, [&buffers] { return FindGatherEvents(buffers); });
+
+    // одна крупная сессия, поделенная на полосы, на всех ядрах; потоки пула
+    // создаются один раз и переиспользуются всеми вызовами
+    const BatchItemGathererProvider* sessions[] = {&buffers};
+    GatherThreadPool pool;
+    const auto parallel_events = Measure("grid, parallel tiles"sv, 20, [&sessions, &pool] {
+        return std::move(FindGatherEventsParallel(sessions, pool, {1024}).front());
+    });
+
+    // полный перебор - миллиард пар, его можно пропустить ключом --fast
+    if (argc > 1 && argv[1] == "--fast"sv) {
+        return 0;
+    }
+
+    const auto expected = Measure("brute force"sv, 1, [&provider] { return FindGatherEventsBruteForce(provider); });
+
+    const auto equal = [](const GatheringEvent& lhs, const GatheringEvent& rhs) {
+        return lhs.item_id == rhs.item_id && lhs.gatherer_id == rhs.gatherer_id
+            && lhs.sq_distance == rhs.sq_distance && lhs.time == rhs.time;
+    };
+
+    const bool same = std::equal(events.begin(), events.end(), expected.begin(), expected.end(), equal)
+        && std::equal(batch_events.begin(), batch_events.end(), expected.begin(), expected.end(), equal)
+        && std::equal(parallel_events.begin(), parallel_events.end(), expected.begin(), expected.end(), equal);
+
+    std::cout << (same ? "results match"sv : "results differ"sv) << std::endl;
+
+    return same ? 0 : 1;
+}
@@ -1,5 +1,7 @@
 #include "collision_detector.h"
 #include <cassert>
+#include <cmath>
+#include <tuple>
 
 namespace collision_detector {
 
@@ -9,24 +11,304 @@ CollectionResult TryCollectPoint(geom::Point2D a, geom::Point2D b, geom::Point2D
     // пскольку при сборе заказов придётся учитывать перемещение даже на небольшое
     // расстояние.
     assert(b.x != a.x || b.y != a.y);
-    const double u_x = c.x - a.x;
-    const double u_y = c.y - a.y;
     const double v_x = b.x - a.x;
     const double v_y = b.y - a.y;
-    const double u_dot_v = u_x * v_x + u_y * v_y;
-    const double u_len2 = u_x * u_x + u_y * u_y;
     const double v_len2 = v_x * v_x + v_y * v_y;
-    const double proj_ratio = u_dot_v / v_len2;
-    const double sq_distance = u_len2 - (u_dot_v * u_dot_v) / v_len2;
 
-    return CollectionResult(sq_distance, proj_ratio);
+    return detail::CollectPoint(a.x, a.y, v_x, v_y, v_len2, c.x, c.y);
+}
+
+ItemGathererBuffers::ItemGathererBuffers(const ItemGathererProvider& provider) {
+    Reserve(provider.ItemsCount(), provider.GatherersCount());
+
+    for (size_t i = 0; i < provider.ItemsCount(); ++i) {
+        AddItem(provider.GetItem(i));
+    }
+
+    for (size_t i = 0; i < provider.GatherersCount(); ++i) {
+        AddGatherer(provider.GetGatherer(i));
+    }
+}
+
+void ItemGathererBuffers::Reserve(size_t items_count, size_t gatherers_count) {
+    for (auto* items : {&item_x_, &item_y_, &item_width_}) {
+        items->reserve(items_count);
+    }
+
+    for (auto* gatherers : {&start_x_, &start_y_, &end_x_, &end_y_, &gatherer_width_}) {
+        gatherers->reserve(gatherers_count);
+    }
+}
+
+void ItemGathererBuffers::AddItem(const Item& item) {
+    item_x_.push_back(item.position.x);
+    item_y_.push_back(item.position.y);
+    item_width_.push_back(item.width);
+}
+
+void ItemGathererBuffers::AddGatherer(const Gatherer& gatherer) {
+    start_x_.push_back(gatherer.start_pos.x);
+    start_y_.push_back(gatherer.start_pos.y);
+    end_x_.push_back(gatherer.end_pos.x);
+    end_y_.push_back(gatherer.end_pos.y);
+    gatherer_width_.push_back(gatherer.width);
+}
+
+ItemsView ItemGathererBuffers::GetItems() const {
+    return {item_x_, item_y_, item_width_};
+}
+
+GatherersView ItemGathererBuffers::GetGatherers() const {
+    return {start_x_, start_y_, end_x_, end_y_, gatherer_width_};
+}
+
+// Порядок событий: по времени, затем по собирателю и предмету - как при полном переборе
+void SortGatherEvents(std::vector<GatheringEvent>& events) {
+    std::sort(events.begin(), events.end(), [](const GatheringEvent& lhs, const GatheringEvent& rhs) {
+        return std::tie(lhs.time, lhs.gatherer_id, lhs.item_id) < std::tie(rhs.time, rhs.gatherer_id, rhs.item_id);
+    });
+}
+
+namespace {
+
+// Предметы, разложенные по равномерной сетке. Клетки идут построчно, предметы клетки
+// лежат подряд, поэтому предметы нескольких соседних клеток одной строки - один
+// непрерывный участок массивов.
+class ItemGrid {
+public:
+    ItemGrid(const ItemsView& items, double query_reach) {
+        const size_t count = items.size();
+
+        assert(items.y.size() == count && items.width.size() == count);
+
+        if (count == 0) {
+            return;
+        }
+
+        min_x_ = max_x_ = items.x[0];
+        min_y_ = max_y_ = items.y[0];
+
+        for (size_t i = 0; i < count; ++i) {
+            min_x_ = std::min(min_x_, items.x[i]);
+            max_x_ = std::max(max_x_, items.x[i]);
+            min_y_ = std::min(min_y_, items.y[i]);
+            max_y_ = std::max(max_y_, items.y[i]);
+            max_width_ = std::max(max_width_, items.width[i]);
+        }
+
+        // клетка не меньше типичного запроса и такая, чтобы на клетку в среднем приходился
+        // хотя бы один предмет; число клеток ограничено числом предметов
+        const double width = std::max(max_x_ - min_x_, 1e-9);
+        const double height = std::max(max_y_ - min_y_, 1e-9);
+
+        cell_size_ = std::max({2 * (query_reach + max_width_), std::sqrt(width * height / count), 1e-9});
+
+        while ((width / cell_size_ + 1) * (height / cell_size_ + 1) > 4.0 * count) {
+            cell_size_ *= 2;
+        }
+
+        columns_ = static_cast<size_t>(width / cell_size_) + 1;
+        rows_ = static_cast<size_t>(height / cell_size_) + 1;
+
+        // сортировка подсчетом по номеру клетки
+        std::vector<size_t> cells(count);
+        cell_start_.assign(columns_ * rows_ + 1, 0);
+
+        for (size_t i = 0; i < count; ++i) {
+            cells[i] = GetRow(items.y[i]) * columns_ + GetColumn(items.x[i]);
+            ++cell_start_[cells[i] + 1];
+        }
+
+        for (size_t cell = 1; cell < cell_start_.size(); ++cell) {
+            cell_start_[cell] += cell_start_[cell - 1];
+        }
+
+        xs_.resize(count);
+        ys_.resize(count);
+        widths_.resize(count);
+        ids_.resize(count);
+
+        std::vector<size_t> next(cell_start_.begin(), cell_start_.end() - 1);
+
+        for (size_t i = 0; i < count; ++i) {
+            const size_t slot = next[cells[i]]++;
+
+            xs_[slot] = items.x[i];
+            ys_[slot] = items.y[i];
+            widths_[slot] = items.width[i];
+            ids_[slot] = i;
+        }
+    }
+
+    bool IsEmpty() const noexcept {
+        return ids_.empty();
+    }
+
+    double GetMaxWidth() const noexcept {
+        return max_width_;
+    }
+
+    // Вызывает fn(begin, end) для участков предметов клеток, пересекающих прямоугольник
+    template <typename Fn>
+    void ForEachRange(double min_x, double min_y, double max_x, double max_y, Fn&& fn) const {
+        if (max_x < min_x_ || min_x > max_x_ || max_y < min_y_ || min_y > max_y_) {
+            return;
+        }
+
+        const size_t first_column = GetColumn(min_x);
+        const size_t last_column = GetColumn(max_x);
+
+        for (size_t row = GetRow(min_y), last_row = GetRow(max_y); row <= last_row; ++row) {
+            const size_t begin = cell_start_[row * columns_ + first_column];
+            const size_t end = cell_start_[row * columns_ + last_column + 1];
+
+            if (begin != end) {
+                fn(begin, end);
+            }
+        }
+    }
+
+    const double* GetXs() const noexcept {
+        return xs_.data();
+    }
+
+    const double* GetYs() const noexcept {
+        return ys_.data();
+    }
+
+    const double* GetWidths() const noexcept {
+        return widths_.data();
+    }
+
+    size_t GetId(size_t slot) const noexcept {
+        return ids_[slot];
+    }
+
+private:
+    double min_x_ = 0;
+    double min_y_ = 0;
+    double max_x_ = 0;
+    double max_y_ = 0;
+    double max_width_ = 0;
+    double cell_size_ = 1;
+    size_t columns_ = 0;
+    size_t rows_ = 0;
+    std::vector<size_t> cell_start_;
+    std::vector<double> xs_;
+    std::vector<double> ys_;
+    std::vector<double> widths_;
+    std::vector<size_t> ids_;
+
+    size_t GetColumn(double x) const noexcept {
+        return std::min(static_cast<size_t>(std::max(0.0, (x - min_x_) / cell_size_)), columns_ - 1);
+    }
+
+    size_t GetRow(double y) const noexcept {
+        return std::min(static_cast<size_t>(std::max(0.0, (y - min_y_) / cell_size_)), rows_ - 1);
+    }
+};
+
+}  // namespace
+
+std::vector<GatheringEvent> FindGatherEvents(const BatchItemGathererProvider& provider) {
+    const auto gatherers = provider.GetGatherers();
+
+    assert(gatherers.start_y.size() == gatherers.size() && gatherers.end_x.size() == gatherers.size()
+           && gatherers.end_y.size() == gatherers.size() && gatherers.width.size() == gatherers.size());
+
+    const double max_gatherer_width =
+        gatherers.size() == 0 ? 0 : *std::max_element(gatherers.width.begin(), gatherers.width.end());
+
+    const ItemGrid grid{provider.GetItems(), max_gatherer_width};
+
+    std::vector<GatheringEvent> events;
+
+    if (grid.IsEmpty()) {
+        return events;
+    }
+
+    const double* xs = grid.GetXs();
+    const double* ys = grid.GetYs();
+    const double* widths = grid.GetWidths();
+
+    // результаты проверки участка: считаются одним простым циклом без ветвлений,
+    // который компилятор может векторизовать, и только потом просматриваются
+    std::vector<double> sq_distances;
+    std::vector<double> proj_ratios;
+
+    for (size_t gatherer_id = 0; gatherer_id < gatherers.size(); ++gatherer_id) {
+        const double a_x = gatherers.start_x[gatherer_id];
+        const double a_y = gatherers.start_y[gatherer_id];
+        const double b_x = gatherers.end_x[gatherer_id];
+        const double b_y = gatherers.end_y[gatherer_id];
+        const double width = gatherers.width[gatherer_id];
+        const double v_x = b_x - a_x;
+        const double v_y = b_y - a_y;
+
+        if (v_x == 0 && v_y == 0) {
+            continue;
+        }
+
+        const double v_len2 = v_x * v_x + v_y * v_y;
+        const double reach = width + grid.GetMaxWidth();
+
+        grid.ForEachRange(std::min(a_x, b_x) - reach, std::min(a_y, b_y) - reach,
+                          std::max(a_x, b_x) + reach, std::max(a_y, b_y) + reach,
+                          [&](size_t begin, size_t end) {
+            const size_t size = end - begin;
+
+            sq_distances.resize(size);
+            proj_ratios.resize(size);
+
+            for (size_t i = 0; i < size; ++i) {
+                const auto result = detail::CollectPoint(a_x, a_y, v_x, v_y, v_len2, xs[begin + i], ys[begin + i]);
+
+                sq_distances[i] = result.sq_distance;
+                proj_ratios[i] = result.proj_ratio;
+            }
+
+            for (size_t i = 0; i < size; ++i) {
+                const CollectionResult result{sq_distances[i], proj_ratios[i]};
+
+                if (result.IsCollected(width + widths[begin + i])) {
+                    events.push_back({grid.GetId(begin + i), gatherer_id, result.sq_distance, result.proj_ratio});
+                }
+            }
+        });
+    }
+
+    SortGatherEvents(events);
+
+    return events;
 }
 
-// В задании на разработку тестов реализовывать следующую функцию не нужно -
-// она будет линковаться извне.
-/*
 std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider) {
+    return FindGatherEvents(ItemGathererBuffers{provider});
+}
+
+std::vector<GatheringEvent> FindGatherEventsBruteForce(const ItemGathererProvider& provider) {
+    std::vector<GatheringEvent> events;
+
+    for (size_t gatherer_id = 0; gatherer_id < provider.GatherersCount(); ++gatherer_id) {
+        const auto gatherer = provider.GetGatherer(gatherer_id);
+
+        if (gatherer.start_pos == gatherer.end_pos) {
+            continue;
+        }
+
+        for (size_t item_id = 0; item_id < provider.ItemsCount(); ++item_id) {
+            const auto item = provider.GetItem(item_id);
+            const auto result = TryCollectPoint(gatherer.start_pos, gatherer.end_pos, item.position);
+
+            if (result.IsCollected(gatherer.width + item.width)) {
+                events.push_back({item_id, gatherer_id, result.sq_distance, result.proj_ratio});
+            }
+        }
+    }
+
+    SortGatherEvents(events);
+
+    return events;
 }
-*/
 
 }  // namespace collision_detector
\ No newline at end of file
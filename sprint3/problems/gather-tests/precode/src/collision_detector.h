@@ -3,6 +3,7 @@
 #include "geom.h"
 
 #include <algorithm>
+#include <span>
 #include <vector>
 
 namespace collision_detector {
@@ -23,6 +24,23 @@ struct CollectionResult {
 // Эта функция реализована в уроке.
 CollectionResult TryCollectPoint(geom::Point2D a, geom::Point2D b, geom::Point2D c);
 
+namespace detail {
+
+// Вычисления TryCollectPoint по координатам. Общие для TryCollectPoint и пакетной
+// проверки в FindGatherEvents, чтобы обе давали одинаковый результат.
+// (v_x, v_y) - перемещение собирателя, v_len2 - квадрат его длины
+inline CollectionResult CollectPoint(double a_x, double a_y, double v_x, double v_y, double v_len2,
+                                     double c_x, double c_y) {
+    const double u_x = c_x - a_x;
+    const double u_y = c_y - a_y;
+    const double u_dot_v = u_x * v_x + u_y * v_y;
+    const double u_len2 = u_x * u_x + u_y * u_y;
+
+    return CollectionResult{u_len2 - (u_dot_v * u_dot_v) / v_len2, u_dot_v / v_len2};
+}
+
+}  // namespace detail
+
 struct Item {
     geom::Point2D position;
     double width;
@@ -45,6 +63,67 @@ public:
     virtual Gatherer GetGatherer(size_t idx) const = 0;
 };
 
+// Предметы в виде непрерывных массивов: i-й предмет - (x[i], y[i]), ширина width[i]
+struct ItemsView {
+    std::span<const double> x;
+    std::span<const double> y;
+    std::span<const double> width;
+
+    size_t size() const {
+        return x.size();
+    }
+};
+
+// Собиратели в виде непрерывных массивов: i-й собиратель идет
+// из (start_x[i], start_y[i]) в (end_x[i], end_y[i]), ширина width[i]
+struct GatherersView {
+    std::span<const double> start_x;
+    std::span<const double> start_y;
+    std::span<const double> end_x;
+    std::span<const double> end_y;
+    std::span<const double> width;
+
+    size_t size() const {
+        return start_x.size();
+    }
+};
+
+// Пакетный вариант ItemGathererProvider: вместо виртуального вызова на каждый
+// предмет и собирателя отдает сразу все массивы, которые детектор читает подряд
+class BatchItemGathererProvider {
+protected:
+    ~BatchItemGathererProvider() = default;
+
+public:
+    virtual ItemsView GetItems() const = 0;
+    virtual GatherersView GetGatherers() const = 0;
+};
+
+// Провайдер, который хранит массивы сам. Заполняется напрямую или копированием
+// из ItemGathererProvider - так существующие провайдеры работают с пакетным детектором.
+class ItemGathererBuffers final : public BatchItemGathererProvider {
+public:
+    ItemGathererBuffers() = default;
+    explicit ItemGathererBuffers(const ItemGathererProvider& provider);
+
+    void Reserve(size_t items_count, size_t gatherers_count);
+    void AddItem(const Item& item);
+    void AddGatherer(const Gatherer& gatherer);
+
+    ItemsView GetItems() const override;
+    GatherersView GetGatherers() const override;
+
+private:
+    std::vector<double> item_x_;
+    std::vector<double> item_y_;
+    std::vector<double> item_width_;
+    std::vector<double> start_x_;
+    std::vector<double> start_y_;
+    std::vector<double> end_x_;
+    std::vector<double> end_y_;
+    std::vector<double> gatherer_width_;
+};
+
 struct GatheringEvent {
     size_t item_id;
     size_t gatherer_id;
@@ -52,8 +131,20 @@ struct GatheringEvent {
     double time;
 };
 
-// Эту функцию вам нужно будет реализовать в соответствующем задании.
-// При проверке ваших тестов она не нужна - функция будет линковаться снаружи.
+// События сбора предметов, упорядоченные по времени (при равном времени - по номеру
+// собирателя, затем предмета). Собиратели, которые не сдвинулись, ничего не собирают.
+// Предметы раскладываются по равномерной сетке, и каждый собиратель проверяет только
+// предметы из клеток, которые задевает его путь, расширенный на радиус сбора.
+std::vector<GatheringEvent> FindGatherEvents(const BatchItemGathererProvider& provider);
+
+// То же для поэлементного провайдера: данные один раз копируются в ItemGathererBuffers
 std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider);
 
+// Упорядочивает события так, как их возвращает FindGatherEvents
+void SortGatherEvents(std::vector<GatheringEvent>& events);
+
+// Та же функция прямым перебором всех пар собиратель-предмет за O(собирателей × предметов).
+// Эталон для тестов и бенчмарка.
+std::vector<GatheringEvent> FindGatherEventsBruteForce(const ItemGathererProvider& provider);
+
 }  // namespace collision_detector
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "parallel_gather.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace collision_detector {
+
+GatherThreadPool::GatherThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    workers_.reserve(threads - 1);
+
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back([this] {
+            Work();
+        });
+    }
+}
+
+GatherThreadPool::~GatherThreadPool() {
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+
+    wake_.notify_all();
+    // jthread дожидается потоков сам
+}
+
+void GatherThreadPool::Run(size_t count, const std::function<void(size_t)>& task) {
+    std::lock_guard run_lock{run_mutex_};
+
+    // одну задачу или пул без рабочих потоков незачем будить
+    if (count <= 1 || workers_.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+
+        return;
+    }
+
+    {
+        std::lock_guard lock{mutex_};
+
+        task_ = &task;
+        count_ = count;
+        next_task_ = 0;
+        error_ = nullptr;
+        finished_ = 0;
+        ++generation_;
+    }
+
+    wake_.notify_all();
+
+    Drain();
+
+    std::unique_lock lock{mutex_};
+
+    // каждый поток участвует в каждом вызове, поэтому после ожидания ни один поток
+    // не обращается к задачам этого вызова
+    done_.wait(lock, [this] {
+        return finished_ == workers_.size();
+    });
+
+    task_ = nullptr;
+
+    if (auto error = std::exchange(error_, nullptr)) {
+        std::rethrow_exception(error);
+    }
+}
+
+GatherThreadPool& GatherThreadPool::GetDefault() {
+    static GatherThreadPool pool;
+
+    return pool;
+}
+
+void GatherThreadPool::Work() {
+    size_t seen = 0;
+
+    std::unique_lock lock{mutex_};
+
+    while (true) {
+        wake_.wait(lock, [this, seen] {
+            return stopping_ || generation_ != seen;
+        });
+
+        if (stopping_) {
+            return;
+        }
+
+        seen = generation_;
+
+        lock.unlock();
+        Drain();
+        lock.lock();
+
+        if (++finished_ == workers_.size()) {
+            done_.notify_one();
+        }
+    }
+}
+
+void GatherThreadPool::Drain() {
+    for (size_t i; (i = next_task_++) < count_;) {
+        try {
+            (*task_)(i);
+        } catch (...) {
+            std::lock_guard lock{mutex_};
+
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
+
+namespace {
+
+// Единица работы: вся сессия или одна полоса крупной сессии
+struct Task {
+    size_t session;
+    // номера собирателей полосы; пусто - вся сессия
+    std::vector<size_t> gatherer_ids;
+    // номера предметов, которые могут задеть собиратели полосы
+    std::vector<size_t> item_ids;
+};
+
+// Делит собирателей сессии на полосы по левому краю пути: в каждой полосе примерно
+// tile_gatherers собирателей, соседние по x собиратели попадают в одну полосу.
+// Предметы раскладываются по полосам за один проход, каждая полоса получает
+// предметы диапазона x, который могут задеть ее собиратели
+void AddTiles(size_t session, const ItemsView& items, const GatherersView& gatherers, size_t tile_gatherers,
+              std::vector<Task>& tasks) {
+    std::vector<double> left(gatherers.size());
+
+    for (size_t i = 0; i < gatherers.size(); ++i) {
+        left[i] = std::min(gatherers.start_x[i], gatherers.end_x[i]);
+    }
+
+    std::vector<size_t> order(gatherers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&left](size_t lhs, size_t rhs) {
+        return left[lhs] < left[rhs] || (left[lhs] == left[rhs] && lhs < rhs);
+    });
+
+    const double max_item_width =
+        items.size() == 0 ? 0 : *std::max_element(items.width.begin(), items.width.end());
+
+    const size_t tiles = (order.size() + tile_gatherers - 1) / tile_gatherers;
+    const size_t first_task = tasks.size();
+
+    // диапазон x каждой полосы
+    std::vector<double> min_x(tiles);
+    std::vector<double> max_x(tiles);
+
+    for (size_t tile = 0; tile < tiles; ++tile) {
+        // границы полос распределяют остаток поровну
+        const auto begin = order.begin() + tile * order.size() / tiles;
+        const auto end = order.begin() + (tile + 1) * order.size() / tiles;
+
+        for (auto it = begin; it != end; ++it) {
+            const size_t id = *it;
+            const double width = gatherers.width[id] + max_item_width;
+
+            const double tile_left = std::min(gatherers.start_x[id], gatherers.end_x[id]) - width;
+            const double tile_right = std::max(gatherers.start_x[id], gatherers.end_x[id]) + width;
+
+            min_x[tile] = it == begin ? tile_left : std::min(min_x[tile], tile_left);
+            max_x[tile] = it == begin ? tile_right : std::max(max_x[tile], tile_right);
+        }
+
+        tasks.push_back({session, {begin, end}, {}});
+    }
+
+    // диапазоны расширяются так, чтобы обе границы не убывали от полосы к полосе:
+    // тогда полосы, которым нужен предмет, идут подряд и находятся двоичным поиском.
+    // Лишние предметы в полосе не меняют результат - каждый собиратель есть только в одной
+    for (size_t tile = tiles - 1; tile-- > 0;) {
+        min_x[tile] = std::min(min_x[tile], min_x[tile + 1]);
+    }
+
+    for (size_t tile = 1; tile < tiles; ++tile) {
+        max_x[tile] = std::max(max_x[tile], max_x[tile - 1]);
+    }
+
+    for (size_t id = 0; id < items.size(); ++id) {
+        const double x = items.x[id];
+
+        // полосы [first, last): max_x >= x и min_x <= x
+        const size_t first = std::lower_bound(max_x.begin(), max_x.end(), x) - max_x.begin();
+        const size_t last = std::upper_bound(min_x.begin(), min_x.end(), x) - min_x.begin();
+
+        for (size_t tile = first; tile < last; ++tile) {
+            tasks[first_task + tile].item_ids.push_back(id);
+        }
+    }
+}
+
+// События одной полосы; номера событий переводятся обратно в номера сессии
+std::vector<GatheringEvent> FindTileEvents(const BatchItemGathererProvider& session, const Task& task) {
+    const auto items = session.GetItems();
+    const auto gatherers = session.GetGatherers();
+
+    ItemGathererBuffers tile;
+    tile.Reserve(task.item_ids.size(), task.gatherer_ids.size());
+
+    for (const size_t id : task.gatherer_ids) {
+        tile.AddGatherer({{gatherers.start_x[id], gatherers.start_y[id]},
+                          {gatherers.end_x[id], gatherers.end_y[id]},
+                          gatherers.width[id]});
+    }
+
+    for (const size_t id : task.item_ids) {
+        tile.AddItem({{items.x[id], items.y[id]}, items.width[id]});
+    }
+
+    auto events = FindGatherEvents(tile);
+
+    for (auto& event : events) {
+        event.item_id = task.item_ids[event.item_id];
+        event.gatherer_id = task.gatherer_ids[event.gatherer_id];
+    }
+
+    return events;
+}
+
+}  // namespace
+
+std::vector<std::vector<GatheringEvent>> FindGatherEventsParallel(
+    std::span<const BatchItemGathererProvider* const> sessions, GatherThreadPool& pool, ParallelGatherOptions options) {
+    const size_t tile_gatherers = std::max<size_t>(options.tile_gatherers, 1);
+
+    std::vector<Task> tasks;
+
+    for (size_t session = 0; session < sessions.size(); ++session) {
+        const auto gatherers = sessions[session]->GetGatherers();
+
+        if (gatherers.size() > tile_gatherers) {
+            AddTiles(session, sessions[session]->GetItems(), gatherers, tile_gatherers, tasks);
+        } else {
+            tasks.push_back({session, {}, {}});
+        }
+    }
+
+    // результат каждой задачи пишется в свою ячейку, поэтому порядок выполнения
+    // не влияет на результат
+    std::vector<std::vector<GatheringEvent>> task_events(tasks.size());
+
+    pool.Run(tasks.size(), [&](size_t i) {
+        const auto& task = tasks[i];
+        const auto& session = *sessions[task.session];
+
+        task_events[i] = task.gatherer_ids.empty() ? FindGatherEvents(session) : FindTileEvents(session, task);
+    });
+
+    // задачи одной сессии идут подряд; события полос сливаются и сортируются заново
+    std::vector<std::vector<GatheringEvent>> result(sessions.size());
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        auto& events = result[tasks[i].session];
+
+        if (tasks[i].gatherer_ids.empty()) {
+            events = std::move(task_events[i]);
+            continue;
+        }
+
+        events.insert(events.end(), task_events[i].begin(), task_events[i].end());
+
+        if (i + 1 == tasks.size() || tasks[i + 1].session != tasks[i].session) {
+            SortGatherEvents(events);
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::vector<GatheringEvent>> FindGatherEventsParallel(
+    std::span<const BatchItemGathererProvider* const> sessions, ParallelGatherOptions options) {
+    return FindGatherEventsParallel(sessions, GatherThreadPool::GetDefault(), options);
+}
+
+}  // namespace collision_detector
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "collision_detector.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace collision_detector {
+
+// Постоянные рабочие потоки для FindGatherEventsParallel. Потоки создаются один раз
+// и ждут работы между вызовами, поэтому параллельный поиск на каждом тике не платит
+// за создание потоков.
+class GatherThreadPool {
+public:
+    // threads - число потоков, включая вызывающий Run; 0 - по числу ядер
+    explicit GatherThreadPool(size_t threads = 0);
+
+    GatherThreadPool(const GatherThreadPool&) = delete;
+    GatherThreadPool& operator=(const GatherThreadPool&) = delete;
+
+    ~GatherThreadPool();
+
+    // Число потоков, включая вызывающий
+    size_t GetThreadCount() const noexcept {
+        return workers_.size() + 1;
+    }
+
+    // Выполняет task(i) для каждого i из [0, count) на потоках пула и вызывающем потоке
+    // и возвращается, когда все задачи выполнены. Первое исключение задачи пробрасывается.
+    // Одновременные вызовы выполняются по очереди.
+    void Run(size_t count, const std::function<void(size_t)>& task);
+
+    // Общий пул на все ядра
+    static GatherThreadPool& GetDefault();
+
+private:
+    std::mutex run_mutex_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    // номер текущего вызова Run: поток берется за работу, когда номер меняется
+    size_t generation_ = 0;
+    // потоков, закончивших текущий вызов
+    size_t finished_ = 0;
+    bool stopping_ = false;
+
+    // задачи текущего вызова; меняются только когда все потоки закончили предыдущий
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_task_{0};
+    std::exception_ptr error_;
+
+    std::vector<std::jthread> workers_;
+
+    void Work();
+    // выполняет задачи текущего вызова, пока они не кончатся
+    void Drain();
+};
+
+struct ParallelGatherOptions {
+    // сессия с большим числом собирателей делится на полосы примерно такого размера
+    size_t tile_gatherers = 4096;
+};
+
+// События сбора для нескольких сессий сразу: i-й элемент результата - то же, что
+// FindGatherEvents(*sessions[i]), включая порядок событий.
+// Сессии независимы и обрабатываются параллельно на потоках pool. Крупная сессия
+// дополнительно делится на вертикальные полосы: собиратели распределяются по полосам,
+// а каждая полоса получает предметы своего диапазона x, расширенного на радиус сбора
+// (перекрытие полос). Так каждая пара собиратель-предмет проверяется ровно в одной
+// полосе, события полос объединяются и сортируются в общем порядке.
+std::vector<std::vector<GatheringEvent>> FindGatherEventsParallel(
+    std::span<const BatchItemGathererProvider* const> sessions, GatherThreadPool& pool,
+    ParallelGatherOptions options = {});
+
+// То же на общем пуле GatherThreadPool::GetDefault()
+std::vector<std::vector<GatheringEvent>> FindGatherEventsParallel(
+    std::span<const BatchItemGathererProvider* const> sessions, ParallelGatherOptions options = {});
+
+}  // namespace collision_detector
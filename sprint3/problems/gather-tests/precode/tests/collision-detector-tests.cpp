@@ -2,4 +2,211 @@
 
 #include "../src/collision_detector.h"
 
-// Напишите здесь тесты для функции collision_detector::FindGatherEvents
\ No newline at end of file
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <tuple>
+
+using namespace collision_detector;
+
+namespace collision_detector {
+
+bool operator==(const GatheringEvent& lhs, const GatheringEvent& rhs) {
+    return lhs.item_id == rhs.item_id && lhs.gatherer_id == rhs.gatherer_id
+        && lhs.sq_distance == rhs.sq_distance && lhs.time == rhs.time;
+}
+
+}  // namespace collision_detector
+
+namespace {
+
+class VectorProvider : public ItemGathererProvider {
+public:
+    VectorProvider(std::vector<Item> items, std::vector<Gatherer> gatherers)
+        : items_{std::move(items)}
+        , gatherers_{std::move(gatherers)} {
+    }
+
+    size_t ItemsCount() const override {
+        return items_.size();
+    }
+
+    Item GetItem(size_t idx) const override {
+        return items_[idx];
+    }
+
+    size_t GatherersCount() const override {
+        return gatherers_.size();
+    }
+
+    Gatherer GetGatherer(size_t idx) const override {
+        return gatherers_[idx];
+    }
+
+private:
+    std::vector<Item> items_;
+    std::vector<Gatherer> gatherers_;
+};
+
+// Пакетный провайдер поверх чужих массивов, без копирования
+class ArraysProvider : public BatchItemGathererProvider {
+public:
+    ArraysProvider(ItemsView items, GatherersView gatherers)
+        : items_{items}
+        , gatherers_{gatherers} {
+    }
+
+    ItemsView GetItems() const override {
+        return items_;
+    }
+
+    GatherersView GetGatherers() const override {
+        return gatherers_;
+    }
+
+private:
+    ItemsView items_;
+    GatherersView gatherers_;
+};
+
+VectorProvider MakeRandomProvider(std::mt19937_64& random, size_t items_count, size_t gatherers_count, double size) {
+    std::uniform_real_distribution<double> coord{0, size};
+    std::uniform_real_distribution<double> step{-5, 5};
+    std::uniform_real_distribution<double> width{0, 0.6};
+
+    std::vector<Item> items;
+    for (size_t i = 0; i < items_count; ++i) {
+        items.push_back({{coord(random), coord(random)}, width(random)});
+    }
+
+    std::vector<Gatherer> gatherers;
+    for (size_t i = 0; i < gatherers_count; ++i) {
+        const geom::Point2D start{coord(random), coord(random)};
+        // часть собирателей стоит на месте
+        const geom::Point2D end = i % 7 == 0 ? start : geom::Point2D{start.x + step(random), start.y + step(random)};
+        gatherers.push_back({start, end, width(random)});
+    }
+
+    return {std::move(items), std::move(gatherers)};
+}
+
+}  // namespace
+
+SCENARIO("Gathering events") {
+    GIVEN("no items or no gatherers") {
+        THEN("there are no events") {
+            CHECK(FindGatherEvents(VectorProvider{{}, {{{0, 0}, {10, 0}, 1}}}).empty());
+            CHECK(FindGatherEvents(VectorProvider{{{{5, 0}, 1}}, {}}).empty());
+        }
+    }
+
+    GIVEN("a gatherer moving along the x axis") {
+        const Gatherer gatherer{{0, 0}, {10, 0}, 0.6};
+
+        THEN("items within the collect radius along the way are collected") {
+            const auto events = FindGatherEvents(VectorProvider{{
+                {{5, 0.5}, 0},     // собран на середине пути
+                {{2, 0}, 0},       // собран раньше
+                {{5, 1}, 0.4},     // ровно на границе радиуса
+                {{5, 1.5}, 0.5},   // слишком далеко
+                {{11, 0}, 0.5},    // за концом пути
+                {{-1, 0}, 0.5},    // до начала пути
+            }, {gatherer}});
+
+            REQUIRE(events.size() == 3);
+
+            CHECK(events[0].item_id == 1);
+            CHECK(events[0].time == 0.2);
+            CHECK(events[0].sq_distance == 0);
+
+            CHECK(events[1].time == 0.5);
+            CHECK(events[2].time == 0.5);
+            CHECK(events[1].item_id == 0);
+            CHECK(events[1].sq_distance == 0.25);
+            CHECK(events[2].item_id == 2);
+        }
+    }
+
+    GIVEN("a gatherer that does not move") {
+        THEN("it collects nothing, even standing on an item") {
+            CHECK(FindGatherEvents(VectorProvider{{{{1, 1}, 1}}, {{{1, 1}, {1, 1}, 1}}}).empty());
+        }
+    }
+
+    GIVEN("several gatherers") {
+        const auto events = FindGatherEvents(VectorProvider{
+            {{{8, 0}, 0}, {{0, 3}, 0}},
+            {{{0, 0}, {10, 0}, 0.5}, {{0, 0}, {0, 10}, 0.5}}
+        });
+
+        THEN("events of all gatherers are ordered by time") {
+            REQUIRE(events.size() == 2);
+            CHECK(events[0].gatherer_id == 1);
+            CHECK(events[0].item_id == 1);
+            CHECK(events[1].gatherer_id == 0);
+            CHECK(events[1].item_id == 0);
+        }
+    }
+
+    GIVEN("random items and gatherers") {
+        std::mt19937_64 random{42};
+
+        THEN("the grid-based search finds exactly the events of the brute force search") {
+            for (auto [items, gatherers, size] : {std::tuple{200, 50, 20.0}, std::tuple{2000, 300, 200.0}, std::tuple{500, 500, 1.0}}) {
+                const auto provider = MakeRandomProvider(random, items, gatherers, size);
+                const auto expected = FindGatherEventsBruteForce(provider);
+
+                CHECK_FALSE(expected.empty());
+                CHECK(FindGatherEvents(provider) == expected);
+            }
+        }
+    }
+
+    GIVEN("items and gatherers given as contiguous arrays") {
+        const double item_x[] = {5, 2, 5, 5};
+        const double item_y[] = {0.5, 0, 1, 1.5};
+        const double item_width[] = {0, 0, 0.4, 0.5};
+        const double start_x[] = {0, 3};
+        const double start_y[] = {0, 3};
+        const double end_x[] = {10, 3};
+        const double end_y[] = {0, 3};
+        const double gatherer_width[] = {0.6, 10};
+
+        const ArraysProvider provider{{item_x, item_y, item_width}, {start_x, start_y, end_x, end_y, gatherer_width}};
+
+        THEN("the detector reads them directly") {
+            const auto events = FindGatherEvents(provider);
+
+            REQUIRE(events.size() == 3);
+            CHECK(events[0].item_id == 1);
+            CHECK(events[1].item_id == 0);
+            CHECK(events[2].item_id == 2);
+
+            for (const auto& event : events) {
+                CHECK(event.gatherer_id == 0);
+            }
+        }
+    }
+
+    GIVEN("a per-element provider") {
+        std::mt19937_64 random{7};
+        const auto provider = MakeRandomProvider(random, 1000, 200, 50.0);
+
+        THEN("copying it into buffers keeps the order and the events") {
+            const ItemGathererBuffers buffers{provider};
+            const auto items = buffers.GetItems();
+            const auto gatherers = buffers.GetGatherers();
+
+            REQUIRE(items.size() == provider.ItemsCount());
+            REQUIRE(gatherers.size() == provider.GatherersCount());
+            CHECK(items.x[10] == provider.GetItem(10).position.x);
+            CHECK(items.width[10] == provider.GetItem(10).width);
+            CHECK(gatherers.end_y[10] == provider.GetGatherer(10).end_pos.y);
+
+            const auto expected = FindGatherEventsBruteForce(provider);
+
+            CHECK_FALSE(expected.empty());
+            CHECK(FindGatherEvents(buffers) == expected);
+            CHECK(FindGatherEvents(provider) == expected);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "../src/parallel_gather.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+
+using namespace collision_detector;
+
+namespace {
+
+bool SameEvents(const std::vector<GatheringEvent>& lhs, const std::vector<GatheringEvent>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const GatheringEvent& a, const GatheringEvent& b) {
+        return a.item_id == b.item_id && a.gatherer_id == b.gatherer_id && a.sq_distance == b.sq_distance
+            && a.time == b.time;
+    });
+}
+
+ItemGathererBuffers MakeRandomSession(std::mt19937_64& random, size_t items_count, size_t gatherers_count, double size) {
+    std::uniform_real_distribution<double> coord{0, size};
+    std::uniform_real_distribution<double> step{-5, 5};
+    std::uniform_real_distribution<double> width{0, 0.6};
+
+    ItemGathererBuffers session;
+
+    for (size_t i = 0; i < items_count; ++i) {
+        session.AddItem({{coord(random), coord(random)}, width(random)});
+    }
+
+    for (size_t i = 0; i < gatherers_count; ++i) {
+        const geom::Point2D start{coord(random), coord(random)};
+        // часть собирателей стоит на месте
+        const geom::Point2D end = i % 7 == 0 ? start : geom::Point2D{start.x + step(random), start.y + step(random)};
+        session.AddGatherer({start, end, width(random)});
+    }
+
+    return session;
+}
+
+}  // namespace
+
+SCENARIO("Parallel gathering") {
+    GIVEN("several sessions of different size") {
+        std::mt19937_64 random{3};
+
+        std::vector<ItemGathererBuffers> sessions;
+        sessions.push_back(MakeRandomSession(random, 200, 50, 20.0));
+        sessions.push_back(MakeRandomSession(random, 0, 10, 20.0));
+        sessions.push_back(MakeRandomSession(random, 3000, 1000, 100.0));
+        sessions.push_back(MakeRandomSession(random, 500, 500, 1.0));
+        sessions.push_back(MakeRandomSession(random, 100, 0, 20.0));
+
+        std::vector<const BatchItemGathererProvider*> providers;
+        for (const auto& session : sessions) {
+            providers.push_back(&session);
+        }
+
+        std::vector<std::vector<GatheringEvent>> expected;
+        for (const auto& session : sessions) {
+            expected.push_back(FindGatherEvents(session));
+        }
+
+        THEN("each session gets exactly the events of the serial search") {
+            GatherThreadPool single{1};
+            GatherThreadPool four{4};
+            GatherThreadPool three{3};
+
+            for (const auto& [pool, tile_gatherers] : {std::pair{&single, size_t{4096}}, std::pair{&four, size_t{4096}},
+                                                       std::pair{&four, size_t{64}}, std::pair{&three, size_t{1}}}) {
+                const auto result = FindGatherEventsParallel(providers, *pool, {tile_gatherers});
+
+                REQUIRE(result.size() == sessions.size());
+
+                for (size_t i = 0; i < sessions.size(); ++i) {
+                    CHECK(SameEvents(result[i], expected[i]));
+                }
+            }
+        }
+
+        THEN("one pool serves many calls") {
+            GatherThreadPool pool{4};
+
+            for (int call = 0; call < 20; ++call) {
+                const auto result = FindGatherEventsParallel(providers, pool, {64});
+
+                REQUIRE(result.size() == sessions.size());
+                CHECK(SameEvents(result[2], expected[2]));
+            }
+        }
+    }
+
+    GIVEN("a large session split into tiles") {
+        std::mt19937_64 random{11};
+        // широкие собиратели и длинные шаги задевают предметы соседних полос
+        std::uniform_real_distribution<double> coord{0, 50};
+        std::uniform_real_distribution<double> step{-20, 20};
+
+        ItemGathererBuffers session;
+
+        for (size_t i = 0; i < 5000; ++i) {
+            session.AddItem({{coord(random), coord(random)}, 0.5});
+        }
+
+        for (size_t i = 0; i < 2000; ++i) {
+            const geom::Point2D start{coord(random), coord(random)};
+            session.AddGatherer({start, {start.x + step(random), start.y + step(random)}, 2});
+        }
+
+        const BatchItemGathererProvider* providers[] = {&session};
+        const auto expected = FindGatherEvents(session);
+
+        THEN("items near tile borders are collected once, in the serial order") {
+            GatherThreadPool pool{4};
+            const auto result = FindGatherEventsParallel(providers, pool, {100});
+
+            REQUIRE(result.size() == 1);
+            CHECK_FALSE(expected.empty());
+            CHECK(SameEvents(result[0], expected));
+        }
+    }
+
+    GIVEN("no sessions") {
+        THEN("the result is empty") {
+            CHECK(FindGatherEventsParallel({}).empty());
+        }
+    }
+}
+
+SCENARIO("Gather thread pool") {
+    GatherThreadPool pool{4};
+
+    GIVEN("many tasks") {
+        std::vector<int> done(1000, 0);
+
+        pool.Run(done.size(), [&done](size_t i) {
+            ++done[i];
+        });
+
+        THEN("each task runs exactly once") {
+            CHECK(std::all_of(done.begin(), done.end(), [](int count) {
+                return count == 1;
+            }));
+        }
+    }
+
+    GIVEN("a task that throws") {
+        THEN("the exception reaches the caller and the pool keeps working") {
+            CHECK_THROWS_AS(pool.Run(100, [](size_t i) {
+                if (i == 42) {
+                    throw std::runtime_error("task failed");
+                }
+            }), std::runtime_error);
+
+            std::atomic<size_t> count{0};
+            pool.Run(100, [&count](size_t) {
+                ++count;
+            });
+
+            CHECK(count == 100);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#include "batch_loot_generator.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace loot_gen {
+
+void BatchLootGenerator::Generate(TimeInterval time_delta, std::span<LootSessionState> states,
+                                  std::span<const double> random_values, std::span<unsigned> generated) {
+    assert(random_values.size() == states.size() && generated.size() == states.size());
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        LootSessionState& state = states[i];
+
+        state.time_without_loot += time_delta;
+
+        // без нехватки трофеев CountLoot вернет 0 при любой вероятности
+        const unsigned loot = state.loot_count >= state.looter_count
+            ? 0u
+            : detail::CountLoot(state.loot_count, state.looter_count,
+                                GetNoLootProbability(state.time_without_loot), random_values[i]);
+
+        if (loot > 0) {
+            state.time_without_loot = {};
+        }
+
+        generated[i] = loot;
+    }
+}
+
+double BatchLootGenerator::GetNoLootProbability(TimeInterval time) {
+    const auto key = time.count();
+    // перемешиваем ключ: времена кратны периоду тика, и младшие биты у них похожи
+    auto& entry = cache_[(static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15) >> 58];
+
+    if (entry.time != key) {
+        const double ratio = std::chrono::duration<double>{time} / base_interval_;
+
+        entry = {key, std::pow(1.0 - probability_, ratio)};
+    }
+
+    return entry.no_loot_probability;
+}
+
+}  // namespace loot_gen
@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "loot_generator.h"
+
+namespace loot_gen {
+
+/*
+ *  Состояние генерации трофеев одной сессии
+ */
+struct LootSessionState {
+    LootGenerator::TimeInterval time_without_loot{};
+    unsigned loot_count = 0;
+    unsigned looter_count = 0;
+};
+
+/*
+ *  Генератор трофеев сразу для всех сессий с одинаковыми настройками генерации.
+ *  Состояния сессий лежат подряд и обрабатываются за один проход на тик.
+ *  Для каждой сессии результат тот же, что дал бы отдельный LootGenerator
+ *  с тем же случайным числом.
+ *
+ *  Время без трофеев у сессий кратно периоду тика и повторяется от сессии к сессии
+ *  и от тика к тику, поэтому std::pow считается один раз на каждое такое время
+ *  и хранится в небольшом кэше с прямым отображением.
+ */
+class BatchLootGenerator {
+public:
+    using TimeInterval = LootGenerator::TimeInterval;
+
+    /*
+     * base_interval, probability - как у LootGenerator
+     */
+    BatchLootGenerator(TimeInterval base_interval, double probability)
+        : base_interval_{base_interval}
+        , probability_{probability} {
+    }
+
+    /*
+     * Один тик для всех сессий: увеличивает время без трофеев на time_delta
+     * и записывает в generated[i] количество трофеев для states[i].
+     * Время без трофеев сбрасывается у сессий, где трофеи появились; loot_count
+     * не меняется - его обновляет тот, кто раскладывает трофеи.
+     * random_values[i] - случайное число от 0 до 1 для i-й сессии
+     */
+    void Generate(TimeInterval time_delta, std::span<LootSessionState> states,
+                  std::span<const double> random_values, std::span<unsigned> generated);
+
+private:
+    static constexpr size_t CACHE_SIZE = 64;
+
+    struct CacheEntry {
+        // время без трофеев в миллисекундах; -1 - запись пуста
+        TimeInterval::rep time = -1;
+        double no_loot_probability = 1;
+    };
+
+    TimeInterval base_interval_;
+    double probability_;
+    std::array<CacheEntry, CACHE_SIZE> cache_{};
+
+    /*
+     * Вероятность того, что за время time трофей не появился бы ни разу
+     */
+    double GetNoLootProbability(TimeInterval time);
+};
+
+}  // namespace loot_gen
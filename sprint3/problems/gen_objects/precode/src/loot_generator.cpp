@@ -6,13 +6,11 @@
 namespace loot_gen {
 
 unsigned LootGenerator::Generate(TimeInterval time_delta, unsigned loot_count,
-                                 unsigned looter_count) {
+                                 unsigned looter_count, double random_value) {
     time_without_loot_ += time_delta;
-    const unsigned loot_shortage = loot_count > looter_count ? 0u : looter_count - loot_count;
     const double ratio = std::chrono::duration<double>{time_without_loot_} / base_interval_;
-    const double probability
-        = std::clamp((1.0 - std::pow(1.0 - probability_, ratio)) * random_generator_(), 0.0, 1.0);
-    const unsigned generated_loot = static_cast<unsigned>(std::round(loot_shortage * probability));
+    const unsigned generated_loot = detail::CountLoot(loot_count, looter_count,
+                                                      std::pow(1.0 - probability_, ratio), random_value);
     if (generated_loot > 0) {
         time_without_loot_ = {};
     }
@@ -1,9 +1,26 @@
 #pragma once
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <functional>
 
 namespace loot_gen {
 
+namespace detail {
+
+/*
+ * Количество трофеев по вероятности того, что за прошедшее время трофей
+ * не появился бы ни разу. Общая часть LootGenerator и BatchLootGenerator.
+ */
+inline unsigned CountLoot(unsigned loot_count, unsigned looter_count, double no_loot_probability,
+                          double random_value) {
+    const unsigned loot_shortage = loot_count > looter_count ? 0u : looter_count - loot_count;
+    const double probability = std::clamp((1.0 - no_loot_probability) * random_value, 0.0, 1.0);
+    return static_cast<unsigned>(std::round(loot_shortage * probability));
+}
+
+}  // namespace detail
+
 /*
  *  Генератор трофеев
  */
@@ -33,7 +50,17 @@ public:
      * loot_count - количество трофеев на карте до вызова Generate
      * looter_count - количество мародёров на карте
      */
-    unsigned Generate(TimeInterval time_delta, unsigned loot_count, unsigned looter_count);
+    unsigned Generate(TimeInterval time_delta, unsigned loot_count, unsigned looter_count) {
+        return Generate(time_delta, loot_count, looter_count, random_generator_());
+    }
+
+    /*
+     * То же, но случайное число от 0 до 1 передается явно, а random_generator
+     * не вызывается. Так генератор работает с любым источником случайных чисел
+     * без косвенного вызова через std::function.
+     */
+    unsigned Generate(TimeInterval time_delta, unsigned loot_count, unsigned looter_count,
+                      double random_value);
 
 private:
     static double DefaultGenerator() noexcept {
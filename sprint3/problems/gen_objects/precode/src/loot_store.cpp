@@ -0,0 +1,180 @@
+#include "loot_store.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace loot_gen {
+
+LootStore::LootStore(std::vector<Road> roads, double cell_size)
+    : roads_{std::move(roads)}
+    , cell_size_{cell_size} {
+    if (roads_.empty()) {
+        throw std::invalid_argument("Loot store needs at least one road");
+    }
+
+    if (!(cell_size_ > 0)) {
+        throw std::invalid_argument("Cell size must be positive");
+    }
+
+    double max_x = min_x_ = roads_.front().start.x;
+    double max_y = min_y_ = roads_.front().start.y;
+    double total_length = 0;
+
+    road_ends_.reserve(roads_.size());
+
+    for (const Road& road : roads_) {
+        min_x_ = std::min({min_x_, road.start.x, road.end.x});
+        min_y_ = std::min({min_y_, road.start.y, road.end.y});
+        max_x = std::max({max_x, road.start.x, road.end.x});
+        max_y = std::max({max_y, road.start.y, road.end.y});
+
+        total_length += std::abs(road.end.x - road.start.x) + std::abs(road.end.y - road.start.y);
+        road_ends_.push_back(total_length);
+    }
+
+    columns_ = static_cast<size_t>((max_x - min_x_) / cell_size_) + 1;
+    rows_ = static_cast<size_t>((max_y - min_y_) / cell_size_) + 1;
+
+    // клетки под осевыми линиями дорог; клетки вне дорог появятся, только если
+    // в них положат трофей
+    for (const Road& road : roads_) {
+        const size_t last_row = GetRow(std::max(road.start.y, road.end.y));
+        const size_t last_column = GetColumn(std::max(road.start.x, road.end.x));
+
+        for (size_t row = GetRow(std::min(road.start.y, road.end.y)); row <= last_row; ++row) {
+            for (size_t column = GetColumn(std::min(road.start.x, road.end.x)); column <= last_column; ++column) {
+                GetOrAddCell(row, column);
+            }
+        }
+    }
+}
+
+LootId LootStore::Add(unsigned type, Point position) {
+    LootId id;
+
+    if (first_free_ != NO_SLOT) {
+        id = first_free_;
+        first_free_ = slots_[id].next_free;
+    } else {
+        id = static_cast<LootId>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    const uint32_t cell_index = GetOrAddCell(GetRow(position.y), GetColumn(position.x));
+    auto& cell = cells_[cell_index];
+
+    Slot& slot = slots_[id];
+    slot.loot = {type, position};
+    slot.cell = cell_index;
+    slot.index_in_cell = static_cast<uint32_t>(cell.size());
+
+    cell.push_back(id);
+    ++size_;
+
+    return id;
+}
+
+bool LootStore::Remove(LootId id) {
+    if (id >= slots_.size() || slots_[id].cell == NO_CELL) {
+        return false;
+    }
+
+    Slot& slot = slots_[id];
+    auto& cell = cells_[slot.cell];
+
+    // на место удаляемого встает последний трофей клетки
+    const LootId moved = cell.back();
+    cell[slot.index_in_cell] = moved;
+    slots_[moved].index_in_cell = slot.index_in_cell;
+    cell.pop_back();
+
+    slot.cell = NO_CELL;
+    slot.next_free = first_free_;
+    first_free_ = id;
+    --size_;
+
+    return true;
+}
+
+const Loot* LootStore::Find(LootId id) const {
+    if (id >= slots_.size() || slots_[id].cell == NO_CELL) {
+        return nullptr;
+    }
+
+    return &slots_[id].loot;
+}
+
+Point LootStore::GetRoadPoint(double road_choice) const {
+    const double total_length = road_ends_.back();
+    const double distance = std::clamp(road_choice, 0.0, 1.0) * total_length;
+
+    // первая дорога, на которой кончается нужное расстояние
+    const auto it = std::lower_bound(road_ends_.begin(), road_ends_.end(), distance);
+    const size_t road_index = std::min<size_t>(it - road_ends_.begin(), roads_.size() - 1);
+
+    const Road& road = roads_[road_index];
+    const double road_start = road_index == 0 ? 0.0 : road_ends_[road_index - 1];
+    const double length = road_ends_[road_index] - road_start;
+
+    if (length == 0) {
+        return road.start;
+    }
+
+    const double ratio = std::clamp((distance - road_start) / length, 0.0, 1.0);
+
+    return {road.start.x + (road.end.x - road.start.x) * ratio, road.start.y + (road.end.y - road.start.y) * ratio};
+}
+
+std::vector<LootId> LootStore::FindNearPath(Point from, Point to, double radius) const {
+    std::vector<LootId> result;
+
+    ForEachInRect({std::min(from.x, to.x) - radius, std::min(from.y, to.y) - radius},
+                  {std::max(from.x, to.x) + radius, std::max(from.y, to.y) + radius},
+                  [&result](LootId id, const Loot&) {
+                      result.push_back(id);
+                  });
+
+    return result;
+}
+
+size_t LootStore::GetColumn(double x) const noexcept {
+    return std::min(static_cast<size_t>(std::max(0.0, (x - min_x_) / cell_size_)), columns_ - 1);
+}
+
+size_t LootStore::GetRow(double y) const noexcept {
+    return std::min(static_cast<size_t>(std::max(0.0, (y - min_y_) / cell_size_)), rows_ - 1);
+}
+
+uint32_t LootStore::GetOrAddCell(size_t row, size_t column) {
+    const auto [it, inserted] = cell_index_.try_emplace(GetCellKey(row, column), static_cast<uint32_t>(cells_.size()));
+
+    if (inserted) {
+        try {
+            cells_.emplace_back();
+        } catch (...) {
+            cell_index_.erase(it);
+            throw;
+        }
+    }
+
+    return it->second;
+}
+
+unsigned SpawnLoot(LootGenerator& generator, LootStore& store, LootGenerator::TimeInterval time_delta,
+                   unsigned looter_count, unsigned loot_types, FastRandom& random) {
+    assert(loot_types > 0);
+
+    const unsigned count
+        = generator.Generate(time_delta, static_cast<unsigned>(store.size()), looter_count, random.NextDouble());
+
+    for (unsigned i = 0; i < count; ++i) {
+        const auto type = static_cast<unsigned>(random.NextBelow(loot_types));
+        store.Add(type, store.GetRoadPoint(random.NextDouble()));
+    }
+
+    return count;
+}
+
+}  // namespace loot_gen
@@ -0,0 +1,169 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "fast_random.h"
+#include "loot_generator.h"
+
+namespace loot_gen {
+
+struct Point {
+    double x;
+    double y;
+};
+
+/*
+ * Дорога - горизонтальный или вертикальный отрезок.
+ * Трофеи лежат на осевой линии дороги.
+ */
+struct Road {
+    Point start;
+    Point end;
+};
+
+struct Loot {
+    unsigned type;
+    Point position;
+};
+
+using LootId = uint32_t;
+
+/*
+ *  Трофеи одной игровой сессии.
+ *  Трофеи разложены по равномерной сетке над дорогами карты: добавление и удаление
+ *  за O(1), поиск в прямоугольнике просматривает только задетые им клетки.
+ *  Хранятся только клетки, через которые проходят дороги, поэтому память зависит
+ *  от длины дорог, а не от площади карты.
+ *  Номер трофея не меняется, пока трофей лежит на карте; номера удаленных трофеев
+ *  используются повторно.
+ */
+class LootStore {
+public:
+    /*
+     * roads - дороги карты, хотя бы одна
+     * cell_size - сторона клетки сетки; разумно брать порядка пути собирателя за тик
+     */
+    explicit LootStore(std::vector<Road> roads, double cell_size = 4.0);
+
+    LootId Add(unsigned type, Point position);
+
+    /*
+     * Возвращает false, если трофея с таким номером нет
+     */
+    bool Remove(LootId id);
+
+    const Loot* Find(LootId id) const;
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    /*
+     * Точка на дорогах карты: road_choice выбирает место на общей длине всех дорог,
+     * так что равномерно распределенное число дает точку, равномерно распределенную
+     * по дорогам. Дорога ищется двоичным поиском по накопленным длинам.
+     * road_choice - число от 0 до 1
+     */
+    Point GetRoadPoint(double road_choice) const;
+
+    /*
+     * Вызывает fn(id, loot) для каждого трофея внутри прямоугольника (границы включены)
+     */
+    template <typename Fn>
+    void ForEachInRect(Point min, Point max, Fn&& fn) const {
+        if (max.x < min.x || max.y < min.y) {
+            return;
+        }
+
+        auto visit_cell = [&](const std::vector<LootId>& cell) {
+            for (const LootId id : cell) {
+                const Loot& loot = slots_[id].loot;
+
+                if (loot.position.x >= min.x && loot.position.x <= max.x
+                    && loot.position.y >= min.y && loot.position.y <= max.y) {
+                    fn(id, loot);
+                }
+            }
+        };
+
+        const size_t first_column = GetColumn(min.x);
+        const size_t last_column = GetColumn(max.x);
+        const size_t first_row = GetRow(min.y);
+        const size_t last_row = GetRow(max.y);
+
+        // прямоугольник задевает больше клеток, чем хранится: дешевле просмотреть все
+        if ((last_column - first_column + 1) * (last_row - first_row + 1) > cells_.size()) {
+            for (const auto& cell : cells_) {
+                visit_cell(cell);
+            }
+
+            return;
+        }
+
+        for (size_t row = first_row; row <= last_row; ++row) {
+            for (size_t column = first_column; column <= last_column; ++column) {
+                if (auto it = cell_index_.find(GetCellKey(row, column)); it != cell_index_.end()) {
+                    visit_cell(cells_[it->second]);
+                }
+            }
+        }
+    }
+
+    /*
+     * Трофеи, которые может задеть собиратель на пути из from в to:
+     * все трофеи в прямоугольнике пути, расширенном на radius
+     */
+    std::vector<LootId> FindNearPath(Point from, Point to, double radius) const;
+
+private:
+    static constexpr uint32_t NO_CELL = UINT32_MAX;
+    static constexpr LootId NO_SLOT = UINT32_MAX;
+
+    struct Slot {
+        Loot loot;
+        // клетка трофея и его место в ней; NO_CELL - слот свободен
+        uint32_t cell = NO_CELL;
+        uint32_t index_in_cell = 0;
+        // следующий свободный слот
+        LootId next_free = NO_SLOT;
+    };
+
+    std::vector<Road> roads_;
+    // накопленные длины дорог: road_ends_[i] - длина дорог 0..i
+    std::vector<double> road_ends_;
+
+    double min_x_ = 0;
+    double min_y_ = 0;
+    double cell_size_;
+    size_t columns_ = 1;
+    size_t rows_ = 1;
+    // только непустые по дорогам клетки; cell_index_ - номер клетки в cells_ по ее ключу
+    std::vector<std::vector<LootId>> cells_;
+    std::unordered_map<uint64_t, uint32_t> cell_index_;
+
+    std::vector<Slot> slots_;
+    LootId first_free_ = NO_SLOT;
+    size_t size_ = 0;
+
+    size_t GetColumn(double x) const noexcept;
+    size_t GetRow(double y) const noexcept;
+
+    uint64_t GetCellKey(size_t row, size_t column) const noexcept {
+        return static_cast<uint64_t>(row) * columns_ + column;
+    }
+
+    // номер клетки в cells_; клетка создается, если ее еще нет
+    uint32_t GetOrAddCell(size_t row, size_t column);
+};
+
+/*
+ * Один шаг появления трофеев: генератор решает, сколько трофеев нужно, и они
+ * кладутся в случайные точки дорог со случайным типом из [0, loot_types).
+ * random - генератор сессии: с одним зерном трофеи появляются одинаково.
+ * Возвращает число добавленных трофеев.
+ */
+unsigned SpawnLoot(LootGenerator& generator, LootStore& store, LootGenerator::TimeInterval time_delta,
+                   unsigned looter_count, unsigned loot_types, FastRandom& random);
+
+}  // namespace loot_gen
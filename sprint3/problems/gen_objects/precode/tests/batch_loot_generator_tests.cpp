@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+
+#include "../src/batch_loot_generator.h"
+
+using namespace std::literals;
+
+SCENARIO("Batched loot generation") {
+    using loot_gen::BatchLootGenerator;
+    using loot_gen::LootGenerator;
+    using loot_gen::LootSessionState;
+    using TimeInterval = LootGenerator::TimeInterval;
+
+    constexpr size_t SESSIONS = 300;
+
+    GIVEN("a batch generator and a scalar generator per session") {
+        BatchLootGenerator batch{5s, 0.5};
+        std::vector<LootGenerator> scalars(SESSIONS, LootGenerator{5s, 0.5});
+
+        std::vector<LootSessionState> states(SESSIONS);
+        std::vector<double> random_values(SESSIONS);
+        std::vector<unsigned> generated(SESSIONS);
+
+        std::mt19937_64 random{9};
+        std::uniform_real_distribution<double> uniform{0, 1};
+        std::uniform_int_distribution<unsigned> count{0, 8};
+
+        WHEN("sessions tick with varying loot, looters and tick periods") {
+            THEN("every session gets the same loot as from its own scalar generator") {
+                for (int tick = 0; tick < 500; ++tick) {
+                    // в основном период 20 мс, иногда тик длиннее
+                    const TimeInterval time_delta = tick % 50 == 0 ? 37ms : 20ms;
+
+                    for (size_t i = 0; i < SESSIONS; ++i) {
+                        states[i].loot_count = count(random);
+                        states[i].looter_count = count(random);
+                        random_values[i] = uniform(random);
+                    }
+
+                    batch.Generate(time_delta, states, random_values, generated);
+
+                    for (size_t i = 0; i < SESSIONS; ++i) {
+                        const unsigned expected = scalars[i].Generate(time_delta, states[i].loot_count,
+                                                                      states[i].looter_count, random_values[i]);
+                        REQUIRE(generated[i] == expected);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("a session without loot shortage") {
+        BatchLootGenerator batch{1s, 1.0};
+        std::vector<LootSessionState> states{{TimeInterval{}, 3, 3}};
+        const std::vector<double> random_values{1.0};
+        std::vector<unsigned> generated(1);
+
+        WHEN("time passes") {
+            batch.Generate(2s, states, random_values, generated);
+
+            THEN("no loot is generated and the time without loot keeps growing") {
+                CHECK(generated[0] == 0);
+                CHECK(states[0].time_without_loot == 2s);
+
+                AND_WHEN("a looter joins") {
+                    states[0].looter_count = 4;
+                    batch.Generate(1s, states, random_values, generated);
+
+                    THEN("loot appears and the time is reset") {
+                        CHECK(generated[0] == 1);
+                        CHECK(states[0].time_without_loot == TimeInterval{});
+                    }
+                }
+            }
+        }
+    }
+}
@@ -71,4 +71,19 @@ SCENARIO("Loot generation") {
             }
         }
     }
+
+    GIVEN("a loot generator called with explicit random values") {
+        LootGenerator gen{1s, 0.5, [] {
+                              return 0.0;
+                          }};
+        WHEN("loot is generated") {
+            THEN("the random value is used instead of the random generator") {
+                const auto time_interval
+                    = std::chrono::duration_cast<TimeInterval>(std::chrono::duration<double>{
+                        1.0 / (std::log(1 - 0.5) / std::log(1.0 - 0.25))});
+                CHECK(gen.Generate(time_interval, 0, 4, 0.5) == 0);
+                CHECK(gen.Generate(time_interval, 0, 4, 0.5) == 1);
+            }
+        }
+    }
 }
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "../src/loot_store.h"
+
+using namespace std::literals;
+
+SCENARIO("Loot store") {
+    using loot_gen::LootId;
+    using loot_gen::LootStore;
+    using loot_gen::Point;
+    using loot_gen::Road;
+
+    GIVEN("a store over two roads") {
+        // горизонтальная дорога длиной 30 и вертикальная длиной 10
+        LootStore store{{Road{{0, 0}, {30, 0}}, Road{{30, 0}, {30, 10}}}};
+
+        WHEN("loot is added") {
+            const LootId first = store.Add(0, {1, 0});
+            const LootId second = store.Add(1, {29, 0});
+            const LootId third = store.Add(1, {30, 5});
+
+            THEN("it can be found by id") {
+                CHECK(store.size() == 3);
+                REQUIRE(store.Find(second) != nullptr);
+                CHECK(store.Find(second)->type == 1);
+                CHECK(store.Find(second)->position.x == 29);
+            }
+
+            THEN("rectangle queries return only loot inside the rectangle") {
+                auto ids = store.FindNearPath({25, 0}, {30, 4}, 1);
+                std::sort(ids.begin(), ids.end());
+
+                CHECK(ids == std::vector{second, third});
+                CHECK(store.FindNearPath({5, 0}, {20, 0}, 0.5).empty());
+                CHECK(store.FindNearPath({0, 0}, {0, 0}, 1) == std::vector{first});
+            }
+
+            AND_WHEN("loot is removed") {
+                CHECK(store.Remove(second));
+
+                THEN("it is no longer found") {
+                    CHECK(store.size() == 2);
+                    CHECK(store.Find(second) == nullptr);
+                    CHECK_FALSE(store.Remove(second));
+                    CHECK(store.FindNearPath({25, 0}, {30, 4}, 1) == std::vector{third});
+                }
+
+                THEN("its id is reused, other ids stay valid") {
+                    CHECK(store.Add(2, {15, 0}) == second);
+                    CHECK(store.Find(first)->position.x == 1);
+                    CHECK(store.Find(third)->position.y == 5);
+                }
+            }
+        }
+
+        THEN("road points are spread over the total length of the roads") {
+            CHECK(store.GetRoadPoint(0).x == 0);
+            CHECK(store.GetRoadPoint(0.5).x == 20);
+            CHECK(store.GetRoadPoint(0.5).y == 0);
+            CHECK(store.GetRoadPoint(0.85).x == 30);
+            CHECK(store.GetRoadPoint(0.85).y == 4);
+            CHECK(store.GetRoadPoint(1).y == 10);
+        }
+    }
+
+    GIVEN("a store with many loot items") {
+        LootStore store{{Road{{0, 0}, {100, 0}}, Road{{0, 0}, {0, 100}}, Road{{0, 100}, {100, 100}}}, 3.0};
+        std::mt19937_64 random{5};
+        std::uniform_real_distribution<double> uniform{0, 1};
+
+        std::vector<LootId> ids;
+        for (int i = 0; i < 2000; ++i) {
+            ids.push_back(store.Add(0, store.GetRoadPoint(uniform(random))));
+        }
+        for (size_t i = 0; i < ids.size(); i += 3) {
+            store.Remove(ids[i]);
+        }
+
+        THEN("queries find the same loot as a full scan") {
+            for (int query = 0; query < 100; ++query) {
+                const Point from{uniform(random) * 100, uniform(random) * 100};
+                const Point to{from.x + uniform(random) * 10 - 5, from.y + uniform(random) * 10 - 5};
+
+                auto found = store.FindNearPath(from, to, 0.6);
+                std::sort(found.begin(), found.end());
+
+                std::vector<LootId> expected;
+                for (size_t i = 0; i < ids.size(); ++i) {
+                    const auto* loot = store.Find(ids[i]);
+                    if (loot && loot->position.x >= std::min(from.x, to.x) - 0.6
+                        && loot->position.x <= std::max(from.x, to.x) + 0.6
+                        && loot->position.y >= std::min(from.y, to.y) - 0.6
+                        && loot->position.y <= std::max(from.y, to.y) + 0.6) {
+                        expected.push_back(ids[i]);
+                    }
+                }
+                std::sort(expected.begin(), expected.end());
+
+                CHECK(found == expected);
+            }
+        }
+    }
+
+    GIVEN("a huge map with a few roads far apart") {
+        // сплошная сетка на такую площадь не поместилась бы в память
+        LootStore store{{Road{{0, 0}, {1'000'000, 0}}, Road{{1'000'000, 0}, {1'000'000, 1'000'000}}}};
+
+        const LootId first = store.Add(0, {10, 0});
+        const LootId second = store.Add(1, {1'000'000, 999'999});
+        // точка вне дорог получает свою клетку
+        const LootId third = store.Add(2, {500'000, 500'000});
+
+        THEN("loot is found near paths") {
+            CHECK(store.FindNearPath({9, 0}, {11, 0}, 0.5) == std::vector{first});
+            CHECK(store.FindNearPath({1'000'000, 999'990}, {1'000'000, 1'000'000}, 1) == std::vector{second});
+            CHECK(store.FindNearPath({500'000, 500'000}, {500'000, 500'000}, 1) == std::vector{third});
+        }
+
+        THEN("a query over the whole map finds all loot") {
+            auto found = store.FindNearPath({0, 0}, {1'000'000, 1'000'000}, 0);
+            std::sort(found.begin(), found.end());
+
+            CHECK(found == std::vector{first, second, third});
+        }
+
+        THEN("removed loot is not found") {
+            CHECK(store.Remove(third));
+            CHECK(store.FindNearPath({500'000, 500'000}, {500'000, 500'000}, 1).empty());
+        }
+    }
+
+    GIVEN("loot generators and stores of two sessions with the same seed") {
+        loot_gen::LootGenerator gen{1s, 0.5};
+        loot_gen::LootGenerator same_gen{1s, 0.5};
+        LootStore store{{Road{{0, 0}, {10, 0}}, Road{{10, 0}, {10, 10}}}};
+        LootStore same_store{{Road{{0, 0}, {10, 0}}, Road{{10, 0}, {10, 10}}}};
+        loot_gen::FastRandom random{17};
+        loot_gen::FastRandom same_random{17};
+
+        WHEN("loot is spawned tick after tick") {
+            unsigned spawned = 0;
+
+            for (int tick = 0; tick < 50; ++tick) {
+                const unsigned count = loot_gen::SpawnLoot(gen, store, 100ms, 20, 3, random);
+
+                REQUIRE(loot_gen::SpawnLoot(same_gen, same_store, 100ms, 20, 3, same_random) == count);
+                spawned += count;
+            }
+
+            THEN("both sessions get the same loot on the roads") {
+                CHECK(spawned > 0);
+                CHECK(store.size() == spawned);
+
+                for (LootId id = 0; id < spawned; ++id) {
+                    const auto* loot = store.Find(id);
+                    const auto* same_loot = same_store.Find(id);
+
+                    REQUIRE(loot != nullptr);
+                    REQUIRE(same_loot != nullptr);
+                    CHECK(loot->type < 3);
+                    CHECK(loot->type == same_loot->type);
+                    CHECK(loot->position.x == same_loot->position.x);
+                    CHECK(loot->position.y == same_loot->position.y);
+                    CHECK((loot->position.y == 0 || loot->position.x == 10));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,196 @@
+#include "leaderboard.h"
+
+#include <utility>
+
+namespace model {
+
+void Leaderboard::Update(const Dog& dog) {
+    if (auto it = ids_.find(*dog.GetId()); it != ids_.end()) {
+        const NodeIndex node = it->second;
+
+        Detach(root_, nodes_[node].entry);
+        nodes_[node].entry.name = dog.GetName();
+        nodes_[node].entry.score = dog.GetScore();
+        Insert(node);
+        return;
+    }
+
+    const NodeIndex node = Allocate({dog.GetId(), dog.GetName(), dog.GetScore()});
+
+    ids_.emplace(*dog.GetId(), node);
+    Insert(node);
+}
+
+void Leaderboard::AddScore(Dog& dog, Score score) {
+    dog.AddScore(score);
+    Update(dog);
+}
+
+bool Leaderboard::Remove(Dog::Id id) {
+    const auto it = ids_.find(*id);
+
+    if (it == ids_.end()) {
+        return false;
+    }
+
+    const NodeIndex node = it->second;
+
+    Detach(root_, nodes_[node].entry);
+    ids_.erase(it);
+
+    nodes_[node].entry.name.clear();
+    nodes_[node].left = first_free_;
+    first_free_ = node;
+
+    return true;
+}
+
+std::optional<size_t> Leaderboard::GetRank(Dog::Id id) const {
+    const auto it = ids_.find(*id);
+
+    if (it == ids_.end()) {
+        return std::nullopt;
+    }
+
+    const Entry& entry = nodes_[it->second].entry;
+    size_t rank = 0;
+
+    for (NodeIndex node = root_; node != NO_NODE;) {
+        const Node& current = nodes_[node];
+
+        if (node == it->second) {
+            return rank + GetSize(current.left);
+        }
+
+        if (IsBefore(entry, current.entry)) {
+            node = current.left;
+        } else {
+            rank += GetSize(current.left) + 1;
+            node = current.right;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<Leaderboard::Entry> Leaderboard::GetPage(size_t start, size_t max_items) const {
+    std::vector<Entry> page;
+
+    if (start >= size() || max_items == 0) {
+        return page;
+    }
+
+    const size_t end = start + std::min(max_items, size() - start);
+
+    page.reserve(end - start);
+    CollectPage(root_, start, end, 0, page);
+
+    return page;
+}
+
+void Leaderboard::UpdateSize(NodeIndex node) noexcept {
+    Node& current = nodes_[node];
+    current.size = GetSize(current.left) + GetSize(current.right) + 1;
+}
+
+void Leaderboard::Split(NodeIndex node, const Entry& entry, NodeIndex& left, NodeIndex& right) {
+    if (node == NO_NODE) {
+        left = right = NO_NODE;
+        return;
+    }
+
+    if (IsBefore(nodes_[node].entry, entry)) {
+        Split(nodes_[node].right, entry, nodes_[node].right, right);
+        left = node;
+    } else {
+        Split(nodes_[node].left, entry, left, nodes_[node].left);
+        right = node;
+    }
+
+    UpdateSize(node);
+}
+
+Leaderboard::NodeIndex Leaderboard::Merge(NodeIndex left, NodeIndex right) {
+    if (left == NO_NODE) {
+        return right;
+    }
+
+    if (right == NO_NODE) {
+        return left;
+    }
+
+    if (nodes_[left].priority > nodes_[right].priority) {
+        nodes_[left].right = Merge(nodes_[left].right, right);
+        UpdateSize(left);
+        return left;
+    }
+
+    nodes_[right].left = Merge(left, nodes_[right].left);
+    UpdateSize(right);
+    return right;
+}
+
+void Leaderboard::Insert(NodeIndex node) {
+    nodes_[node].left = nodes_[node].right = NO_NODE;
+    nodes_[node].size = 1;
+
+    NodeIndex left;
+    NodeIndex right;
+
+    Split(root_, nodes_[node].entry, left, right);
+    root_ = Merge(Merge(left, node), right);
+}
+
+void Leaderboard::Detach(NodeIndex& node, const Entry& entry) {
+    Node& current = nodes_[node];
+
+    if (current.entry.id == entry.id) {
+        node = Merge(current.left, current.right);
+        return;
+    }
+
+    Detach(IsBefore(entry, current.entry) ? current.left : current.right, entry);
+    UpdateSize(node);
+}
+
+Leaderboard::NodeIndex Leaderboard::Allocate(Entry entry) {
+    // приоритеты из splitmix64: дерево сбалансировано в среднем при любом порядке вставок
+    uint64_t z = (priority_state_ += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+
+    NodeIndex node;
+
+    if (first_free_ != NO_NODE) {
+        node = first_free_;
+        first_free_ = nodes_[node].left;
+    } else {
+        node = static_cast<NodeIndex>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    nodes_[node].entry = std::move(entry);
+    nodes_[node].priority = z ^ (z >> 31);
+
+    return node;
+}
+
+void Leaderboard::CollectPage(NodeIndex node, size_t start, size_t end, size_t offset,
+                              std::vector<Entry>& out) const {
+    if (node == NO_NODE || offset >= end || offset + GetSize(node) <= start) {
+        return;
+    }
+
+    const Node& current = nodes_[node];
+    const size_t position = offset + GetSize(current.left);
+
+    CollectPage(current.left, start, end, offset, out);
+
+    if (position >= start && position < end) {
+        out.push_back(current.entry);
+    }
+
+    CollectPage(current.right, start, end, position + 1, out);
+}
+
+}  // namespace model
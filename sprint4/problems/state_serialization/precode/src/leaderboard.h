@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model.h"
+
+namespace model {
+
+/*
+ * Таблица лидеров: собаки, упорядоченные по убыванию очков (при равенстве - по id).
+ * Хранится в декартовом дереве с размерами поддеревьев, поэтому изменение очков,
+ * место собаки и k-я запись находятся за O(log n), а страница из k записей -
+ * за O(log n + k). Узлы лежат в одном векторе, удаленные используются повторно.
+ */
+class Leaderboard {
+public:
+    struct Entry {
+        Dog::Id id{0u};
+        std::string name;
+        Score score{};
+    };
+
+    /*
+     * Добавляет собаку или обновляет ее очки после изменения снаружи
+     * (например, после восстановления состояния)
+     */
+    void Update(const Dog& dog);
+
+    /*
+     * Начисляет очки собаке и сразу переставляет ее в таблице
+     */
+    void AddScore(Dog& dog, Score score);
+
+    bool Remove(Dog::Id id);
+
+    /*
+     * Место собаки, начиная с 0; nullopt - собаки нет в таблице
+     */
+    std::optional<size_t> GetRank(Dog::Id id) const;
+
+    /*
+     * Не больше max_items записей, начиная с места start
+     */
+    std::vector<Entry> GetPage(size_t start, size_t max_items) const;
+
+    size_t size() const noexcept {
+        return ids_.size();
+    }
+
+private:
+    using NodeIndex = uint32_t;
+    static constexpr NodeIndex NO_NODE = UINT32_MAX;
+
+    struct Node {
+        Entry entry;
+        uint64_t priority = 0;
+        // в свободном узле left - следующий свободный узел
+        NodeIndex left = NO_NODE;
+        NodeIndex right = NO_NODE;
+        // размер поддерева
+        uint32_t size = 1;
+    };
+
+    std::vector<Node> nodes_;
+    NodeIndex root_ = NO_NODE;
+    NodeIndex first_free_ = NO_NODE;
+    // узел каждой собаки
+    std::unordered_map<uint32_t, NodeIndex> ids_;
+    // состояние генератора приоритетов узлов
+    uint64_t priority_state_ = 0;
+
+    // порядок таблицы: больше очков - выше, при равенстве выше меньший id
+    static bool IsBefore(const Entry& lhs, const Entry& rhs) noexcept {
+        return lhs.score != rhs.score ? lhs.score > rhs.score : *lhs.id < *rhs.id;
+    }
+
+    uint32_t GetSize(NodeIndex node) const noexcept {
+        return node == NO_NODE ? 0 : nodes_[node].size;
+    }
+
+    void UpdateSize(NodeIndex node) noexcept;
+
+    // разделяет дерево на узлы раньше entry и остальные
+    void Split(NodeIndex node, const Entry& entry, NodeIndex& left, NodeIndex& right);
+    // сливает деревья, все узлы left раньше узлов right
+    NodeIndex Merge(NodeIndex left, NodeIndex right);
+
+    // вставляет в дерево отдельный узел
+    void Insert(NodeIndex node);
+    // убирает из поддерева node узел записи entry, не освобождая его
+    void Detach(NodeIndex& node, const Entry& entry);
+
+    NodeIndex Allocate(Entry entry);
+
+    void CollectPage(NodeIndex node, size_t start, size_t end, size_t offset, std::vector<Entry>& out) const;
+};
+
+}  // namespace model
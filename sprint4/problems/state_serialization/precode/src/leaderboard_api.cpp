@@ -0,0 +1,153 @@
+#include "leaderboard_api.h"
+
+#include <charconv>
+#include <cstdio>
+
+namespace leaderboard_api {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr std::string_view LEADERBOARD_PATH = "/api/v1/game/leaderboard"sv;
+constexpr std::string_view RANK_PATH = "/api/v1/game/leaderboard/rank"sv;
+
+struct BadRequest {
+    std::string message;
+};
+
+Response MakeError(unsigned status, std::string_view code, std::string_view message) {
+    std::string body = "{\"code\":\""s;
+    body += code;
+    body += "\",\"message\":\""sv;
+    body += message;
+    body += "\"}"sv;
+
+    return {status, std::move(body)};
+}
+
+void AppendString(std::string& out, std::string_view value) {
+    out += '"';
+
+    for (const char c : value) {
+        switch (c) {
+            case '"':
+                out += "\\\""sv;
+                break;
+            case '\\':
+                out += "\\\\"sv;
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+
+    out += '"';
+}
+
+// Значение параметра запроса name; nullopt, если параметра нет
+std::optional<size_t> GetParameter(std::string_view query, std::string_view name) {
+    while (!query.empty()) {
+        const auto amp = query.find('&');
+        const auto parameter = query.substr(0, amp);
+        query = amp == std::string_view::npos ? std::string_view{} : query.substr(amp + 1);
+
+        const auto eq = parameter.find('=');
+
+        if (parameter.substr(0, eq) != name) {
+            continue;
+        }
+
+        const auto value = eq == std::string_view::npos ? std::string_view{} : parameter.substr(eq + 1);
+        size_t result = 0;
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+
+        if (ec != std::errc{} || end != value.data() + value.size() || value.empty()) {
+            throw BadRequest{std::string{name} + " must be a non-negative integer"s};
+        }
+
+        return result;
+    }
+
+    return std::nullopt;
+}
+
+Response GetPage(const model::Leaderboard& leaderboard, std::string_view query) {
+    const size_t start = GetParameter(query, "start"sv).value_or(0);
+    const size_t max_items = GetParameter(query, "maxItems"sv).value_or(MAX_ITEMS);
+
+    if (max_items > MAX_ITEMS) {
+        throw BadRequest{"maxItems must not exceed "s + std::to_string(MAX_ITEMS)};
+    }
+
+    std::string body = "["s;
+
+    for (const auto& entry : leaderboard.GetPage(start, max_items)) {
+        if (body.size() > 1) {
+            body += ',';
+        }
+
+        body += "{\"dogId\":"sv;
+        body += std::to_string(*entry.id);
+        body += ",\"name\":"sv;
+        AppendString(body, entry.name);
+        body += ",\"score\":"sv;
+        body += std::to_string(entry.score);
+        body += '}';
+    }
+
+    body += ']';
+
+    return {200, std::move(body)};
+}
+
+Response GetRank(const model::Leaderboard& leaderboard, std::string_view query) {
+    const auto dog_id = GetParameter(query, "dogId"sv);
+
+    if (!dog_id || *dog_id > UINT32_MAX) {
+        throw BadRequest{"dogId is required"s};
+    }
+
+    const model::Dog::Id id{static_cast<uint32_t>(*dog_id)};
+    const auto rank = leaderboard.GetRank(id);
+
+    if (!rank) {
+        return MakeError(404, "dogNotFound"sv, "Dog not found"sv);
+    }
+
+    const auto entry = leaderboard.GetPage(*rank, 1).front();
+
+    return {200, "{\"dogId\":"s + std::to_string(*dog_id) + ",\"rank\":"s + std::to_string(*rank) + ",\"score\":"s
+                     + std::to_string(entry.score) + "}"s};
+}
+
+}  // namespace
+
+std::optional<Response> HandleRequest(const model::Leaderboard& leaderboard, std::string_view method,
+                                      std::string_view target) {
+    const auto question = target.find('?');
+    const auto path = target.substr(0, question);
+    const auto query = question == std::string_view::npos ? std::string_view{} : target.substr(question + 1);
+
+    if (path != LEADERBOARD_PATH && path != RANK_PATH) {
+        return std::nullopt;
+    }
+
+    if (method != "GET"sv && method != "HEAD"sv) {
+        return MakeError(405, "invalidMethod"sv, "Only GET method is expected"sv);
+    }
+
+    try {
+        return path == RANK_PATH ? GetRank(leaderboard, query) : GetPage(leaderboard, query);
+    } catch (const BadRequest& error) {
+        return MakeError(400, "invalidArgument"sv, error.message);
+    }
+}
+
+}  // namespace leaderboard_api
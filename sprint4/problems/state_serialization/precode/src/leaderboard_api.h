@@ -0,0 +1,32 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "leaderboard.h"
+
+namespace leaderboard_api {
+
+struct Response {
+    unsigned status;
+    std::string body;
+};
+
+// Больше записей за один запрос не отдается
+constexpr size_t MAX_ITEMS = 100;
+
+/*
+ * Запросы к таблице лидеров. Ответ - JSON; nullopt, если target не относится к таблице.
+ *
+ * GET /api/v1/game/leaderboard?start=0&maxItems=100
+ *     записи с места start (по умолчанию 0), не больше maxItems (по умолчанию и
+ *     не больше MAX_ITEMS): [{"dogId":1,"name":"Rex","score":10}, ...]
+ * GET /api/v1/game/leaderboard/rank?dogId=1
+ *     место собаки, начиная с 0: {"dogId":1,"rank":0,"score":10}
+ *
+ * Методы кроме GET и HEAD - 405, неверные параметры - 400, неизвестная собака - 404.
+ */
+std::optional<Response> HandleRequest(const model::Leaderboard& leaderboard, std::string_view method,
+                                      std::string_view target);
+
+}  // namespace leaderboard_api
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "../src/leaderboard.h"
+#include "../src/leaderboard_api.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace {
+
+Dog MakeDog(uint32_t id, std::string name) {
+    return Dog{Dog::Id{id}, std::move(name), {0, 0}, 3};
+}
+
+}  // namespace
+
+SCENARIO("Leaderboard") {
+    Leaderboard leaderboard;
+
+    GIVEN("dogs with scores") {
+        auto rex = MakeDog(1, "Rex"s);
+        auto bim = MakeDog(2, "Bim"s);
+        auto tuzik = MakeDog(3, "Tuzik"s);
+
+        leaderboard.AddScore(rex, 10);
+        leaderboard.AddScore(bim, 30);
+        leaderboard.Update(tuzik);
+
+        THEN("they are ordered by score") {
+            const auto page = leaderboard.GetPage(0, 10);
+
+            REQUIRE(page.size() == 3);
+            CHECK(page[0].name == "Bim"s);
+            CHECK(page[1].name == "Rex"s);
+            CHECK(page[2].name == "Tuzik"s);
+            CHECK(leaderboard.GetRank(Dog::Id{1u}) == 1u);
+        }
+
+        WHEN("a dog gets more score") {
+            leaderboard.AddScore(rex, 25);
+
+            THEN("it moves up") {
+                CHECK(rex.GetScore() == 35);
+                CHECK(leaderboard.GetRank(Dog::Id{1u}) == 0u);
+                CHECK(leaderboard.GetRank(Dog::Id{2u}) == 1u);
+            }
+        }
+
+        WHEN("scores are equal") {
+            leaderboard.AddScore(tuzik, 10);
+
+            THEN("the dog with the smaller id goes first") {
+                CHECK(leaderboard.GetRank(Dog::Id{1u}) == 1u);
+                CHECK(leaderboard.GetRank(Dog::Id{3u}) == 2u);
+            }
+        }
+
+        WHEN("a dog is removed") {
+            CHECK(leaderboard.Remove(Dog::Id{2u}));
+
+            THEN("it has no rank and the others move up") {
+                CHECK_FALSE(leaderboard.GetRank(Dog::Id{2u}).has_value());
+                CHECK_FALSE(leaderboard.Remove(Dog::Id{2u}));
+                CHECK(leaderboard.GetRank(Dog::Id{1u}) == 0u);
+                CHECK(leaderboard.size() == 2);
+            }
+        }
+    }
+
+    GIVEN("many dogs with random scores") {
+        std::mt19937_64 random{4};
+        std::uniform_int_distribution<unsigned> score{0, 50};
+        std::uniform_int_distribution<uint32_t> dog_index{0, 499};
+
+        std::vector<Dog> dogs;
+        std::vector<bool> present(500, true);
+        for (uint32_t id = 0; id < 500; ++id) {
+            dogs.push_back(MakeDog(id, "dog"s + std::to_string(id)));
+            leaderboard.Update(dogs.back());
+        }
+
+        for (int step = 0; step < 5000; ++step) {
+            const auto index = dog_index(random);
+
+            if (step % 10 == 0) {
+                present[index] = !present[index];
+                present[index] ? leaderboard.Update(dogs[index]) : (void)leaderboard.Remove(dogs[index].GetId());
+            } else if (present[index]) {
+                leaderboard.AddScore(dogs[index], score(random));
+            }
+        }
+
+        THEN("pages and ranks match a sorted list") {
+            std::vector<const Dog*> expected;
+            for (uint32_t id = 0; id < 500; ++id) {
+                if (present[id]) {
+                    expected.push_back(&dogs[id]);
+                }
+            }
+            std::sort(expected.begin(), expected.end(), [](const Dog* lhs, const Dog* rhs) {
+                return lhs->GetScore() != rhs->GetScore() ? lhs->GetScore() > rhs->GetScore()
+                                                          : *lhs->GetId() < *rhs->GetId();
+            });
+
+            REQUIRE(leaderboard.size() == expected.size());
+
+            for (size_t rank = 0; rank < expected.size(); ++rank) {
+                REQUIRE(leaderboard.GetRank(expected[rank]->GetId()) == rank);
+            }
+
+            for (size_t start : {size_t{0}, size_t{7}, expected.size() - 3, expected.size() + 1}) {
+                const auto page = leaderboard.GetPage(start, 20);
+
+                REQUIRE(page.size() == std::min<size_t>(20, expected.size() - std::min(start, expected.size())));
+
+                for (size_t i = 0; i < page.size(); ++i) {
+                    CHECK(page[i].id == expected[start + i]->GetId());
+                    CHECK(page[i].score == expected[start + i]->GetScore());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Leaderboard requests") {
+    Leaderboard leaderboard;
+
+    auto rex = MakeDog(1, "Rex \"the dog\""s);
+    auto bim = MakeDog(2, "Bim"s);
+    leaderboard.AddScore(rex, 10);
+    leaderboard.AddScore(bim, 30);
+
+    using leaderboard_api::HandleRequest;
+
+    GIVEN("a request for the top") {
+        THEN("records are returned as JSON") {
+            const auto response = HandleRequest(leaderboard, "GET"sv, "/api/v1/game/leaderboard"sv);
+
+            REQUIRE(response.has_value());
+            CHECK(response->status == 200);
+            CHECK(response->body
+                  == R"([{"dogId":2,"name":"Bim","score":30},{"dogId":1,"name":"Rex \"the dog\"","score":10}])"s);
+        }
+
+        THEN("start and maxItems select a page") {
+            const auto response
+                = HandleRequest(leaderboard, "GET"sv, "/api/v1/game/leaderboard?start=1&maxItems=1"sv);
+
+            REQUIRE(response.has_value());
+            CHECK(response->body == R"([{"dogId":1,"name":"Rex \"the dog\"","score":10}])"s);
+        }
+
+        THEN("invalid parameters are rejected") {
+            CHECK(HandleRequest(leaderboard, "GET"sv, "/api/v1/game/leaderboard?maxItems=101"sv)->status == 400);
+            CHECK(HandleRequest(leaderboard, "GET"sv, "/api/v1/game/leaderboard?start=-1"sv)->status == 400);
+            CHECK(HandleRequest(leaderboard, "POST"sv, "/api/v1/game/leaderboard"sv)->status == 405);
+        }
+    }
+
+    GIVEN("a request for a rank") {
+        THEN("the rank of a known dog is returned") {
+            const auto response = HandleRequest(leaderboard, "GET"sv, "/api/v1/game/leaderboard/rank?dogId=1"sv);
+
+            REQUIRE(response.has_value());
+            CHECK(response->status == 200);
+            CHECK(response->body == R"({"dogId":1,"rank":1,"score":10})"s);
+        }
+
+        THEN("an unknown dog is not found") {
+            CHECK(HandleRequest(leaderboard, "GET"sv, "/api/v1/game/leaderboard/rank?dogId=7"sv)->status == 404);
+            CHECK(HandleRequest(leaderboard, "GET"sv, "/api/v1/game/leaderboard/rank"sv)->status == 400);
+        }
+    }
+
+    GIVEN("another target") {
+        THEN("the request is not handled") {
+            CHECK_FALSE(HandleRequest(leaderboard, "GET"sv, "/api/v1/maps"sv).has_value());
+        }
+    }
+}